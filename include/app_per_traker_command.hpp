@@ -1,5 +1,10 @@
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -10,10 +15,23 @@
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "bplus_tree.hpp"
+#include "column_codec.hpp"
+#include "date_utils.hpp"
+#include "fenwick_tree.hpp"
+#include "file_tail.hpp"
+#include "fuzzy_search.hpp"
+#include "pipeline.hpp"
+#include "sketches.hpp"
+
 namespace expense_tracker {
 // forward decalrations
 class Expense; //
@@ -165,7 +183,649 @@ public:
 };
 } // namespace validator
 
+namespace stats {
+/**
+ * @brief Size and modification time identifying one version of a file
+ */
+struct FileStamp {
+  std::uint64_t size = 0;
+  std::int64_t writeTime = 0; // file clock ticks
+
+  bool operator==(const FileStamp &other) const {
+    return size == other.size && writeTime == other.writeTime;
+  }
+
+  /// Stamp of @p path as it is now, std::nullopt if it cannot be examined.
+  static std::optional<FileStamp> of(const fs::path &path) {
+    std::error_code ec;
+    const auto size = fs::file_size(path, ec);
+    if (ec) {
+      return std::nullopt;
+    }
+    const auto writeTime = fs::last_write_time(path, ec);
+    if (ec) {
+      return std::nullopt;
+    }
+    return FileStamp{static_cast<std::uint64_t>(size),
+                     static_cast<std::int64_t>(
+                         writeTime.time_since_epoch().count())};
+  }
+};
+
+/**
+ * @brief Mergeable summaries maintained as expenses are added
+ *
+ * Amount quantiles (KLL) overall and per category, a HyperLogLog of
+ * distinct titles and Count-Min / Space-Saving sketches of title
+ * frequency. Queries cost the same whatever the number of rows. Sketches
+ * cannot forget a row, so repositories rebuild them after updates and
+ * removals.
+ */
+class ExpenseSketches {
+public:
+  void add(const models::Expense &e) {
+    amounts_.add(e.getAmount());
+    byCategory_[e.getCategory()].add(e.getAmount());
+    titles_.add(e.getTitle());
+    titleCounts_.add(e.getTitle());
+    topTitles_.add(e.getTitle());
+  }
+  void merge(const ExpenseSketches &other) {
+    amounts_.merge(other.amounts_);
+    for (const auto &[category, sketch] : other.byCategory_) {
+      byCategory_[category].merge(sketch);
+    }
+    titles_.merge(other.titles_);
+    titleCounts_.merge(other.titleCounts_);
+    topTitles_.merge(other.topTitles_);
+  }
+  void clear() { *this = ExpenseSketches{}; }
+
+  std::uint64_t rows() const noexcept { return amounts_.count(); }
+  const sketches::KllSketch &amounts() const noexcept { return amounts_; }
+  const std::map<std::string, sketches::KllSketch> &byCategory() const {
+    return byCategory_;
+  }
+  double distinctTitles() const { return titles_.estimate(); }
+  std::uint64_t titleFrequency(const std::string &title) const {
+    return titleCounts_.estimate(title);
+  }
+  /// Space-Saving candidates, with counts tightened by Count-Min (both are
+  /// upper bounds, so the smaller one is kept).
+  std::vector<sketches::SpaceSaving::Entry> topTitles(size_t k) const {
+    auto candidates = topTitles_.top(std::numeric_limits<size_t>::max());
+    for (auto &entry : candidates) {
+      entry.count = std::min(entry.count, titleCounts_.estimate(entry.item));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.count > b.count;
+                     });
+    if (candidates.size() > k) {
+      candidates.resize(k);
+    }
+    return candidates;
+  }
+
+  /**
+   * @brief Writes the sketches to @p filepath, stamped with the data file
+   * they summarise
+   *
+   * loadFromFile() only accepts them back while @p source is unchanged, so a
+   * data file rewritten behind the repository's back is not described by
+   * stale sketches.
+   */
+  bool saveToFile(const fs::path &filepath, const fs::path &source) const {
+    auto stamp = FileStamp::of(source);
+    if (!stamp) {
+      return false;
+    }
+    std::string out(kMagic, sizeof(kMagic));
+    codec::putVarint(out, stamp->size);
+    codec::putVarint(out, codec::zigzag(stamp->writeTime));
+    amounts_.serialize(out);
+    codec::putVarint(out, byCategory_.size());
+    for (const auto &[category, sketch] : byCategory_) {
+      codec::putVarint(out, category.size());
+      out += category;
+      sketch.serialize(out);
+    }
+    titles_.serialize(out);
+    titleCounts_.serialize(out);
+    topTitles_.serialize(out);
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file << out;
+    return static_cast<bool>(file);
+  }
+  static std::optional<ExpenseSketches> loadFromFile(const fs::path &filepath,
+                                                     const fs::path &source) {
+    std::ifstream file(filepath, std::ios::binary);
+    auto stamp = FileStamp::of(source);
+    if (!file.is_open() || !stamp) {
+      return std::nullopt;
+    }
+    std::string data{std::istreambuf_iterator<char>(file), {}};
+    if (data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+      return std::nullopt;
+    }
+    try {
+      codec::Reader in{data.data() + sizeof(kMagic),
+                       data.size() - sizeof(kMagic)};
+      FileStamp written;
+      written.size = in.varint();
+      written.writeTime = codec::unzigzag(in.varint());
+      if (!(written == *stamp)) {
+        return std::nullopt;
+      }
+      ExpenseSketches result;
+      result.amounts_ = sketches::KllSketch::deserialize(in);
+      for (size_t n = in.varint(); n > 0; --n) {
+        std::string category = in.bytes();
+        result.byCategory_.emplace(std::move(category),
+                                   sketches::KllSketch::deserialize(in));
+      }
+      result.titles_ = sketches::HyperLogLog::deserialize(in);
+      result.titleCounts_ = sketches::CountMinSketch::deserialize(in);
+      result.topTitles_ = sketches::SpaceSaving::deserialize(in);
+      return result;
+    } catch (const std::exception &) {
+      return std::nullopt;
+    }
+  }
+
+private:
+  static constexpr char kMagic[8] = {'E', 'X', 'S', 'K', 'E', 'T', '0', '2'};
+
+  sketches::KllSketch amounts_;
+  std::map<std::string, sketches::KllSketch> byCategory_;
+  sketches::HyperLogLog titles_;
+  sketches::CountMinSketch titleCounts_;
+  sketches::SpaceSaving topTitles_;
+};
+} // namespace stats
+
+namespace rollups {
+/**
+ * @brief Day-granularity spend, overall and per category, in Fenwick trees
+ *
+ * Amounts are summed as integer cents so removals cancel additions
+ * exactly. Days are grouped into blocks of kSpan days, each a Fenwick tree
+ * created by the first expense falling in it, so memory follows the days
+ * that hold data: a stray far-off date costs one block, not the span up to
+ * it. Block totals are indexed the same way, kSpan blocks (about 718
+ * years) to a tree, so a range total reads the two partial blocks at its
+ * ends plus the block trees in between: O(log kSpan) per level, with at
+ * most 15 block trees across years 0000-9999. Every add/remove updates one
+ * tree per level. Expenses whose date cannot be parsed are not counted.
+ */
+class DailyTotals {
+public:
+  void add(const models::Expense &e) { apply(e, 1); }
+  void remove(const models::Expense &e) { apply(e, -1); }
+  void clear() { *this = DailyTotals{}; }
+
+  /// Total of days [fromDay, toDay]; an empty @p category means all.
+  double rangeTotal(std::int64_t fromDay, std::int64_t toDay,
+                    const std::string &category = "") const {
+    const Series *series = &overall_;
+    if (!category.empty()) {
+      auto it = byCategory_.find(category);
+      if (it == byCategory_.end()) {
+        return 0.0;
+      }
+      series = &it->second;
+    }
+    if (fromDay > toDay) {
+      return 0.0;
+    }
+    const std::int64_t firstBlock = groupOf(fromDay);
+    const std::int64_t lastBlock = groupOf(toDay);
+    std::int64_t cents;
+    if (lastBlock - firstBlock < 2) {
+      cents = sum(series->days, fromDay, toDay);
+    } else {
+      cents = sum(series->days, fromDay, firstBlock * kSpan + kSpan - 1) +
+              sum(series->blocks, firstBlock + 1, lastBlock - 1) +
+              sum(series->days, lastBlock * kSpan, toDay);
+    }
+    return static_cast<double>(cents) / 100;
+  }
+
+private:
+  static constexpr std::int64_t kSpan = 512;
+  // group number -> Fenwick tree over the kSpan positions of that group
+  using Trees = std::map<std::int64_t, FenwickTree<std::int64_t>>;
+  struct Series {
+    Trees days;   // positions are days, grouped into blocks
+    Trees blocks; // positions are block totals
+  };
+
+  Series overall_;
+  std::unordered_map<std::string, Series> byCategory_;
+
+  static std::int64_t groupOf(std::int64_t position) {
+    return (position >= 0 ? position : position - kSpan + 1) / kSpan;
+  }
+
+  static void add(Trees &trees, std::int64_t position, std::int64_t cents) {
+    const std::int64_t group = groupOf(position);
+    auto it = trees.find(group);
+    if (it == trees.end()) {
+      it = trees.emplace(group, FenwickTree<std::int64_t>(kSpan)).first;
+    }
+    it->second.add(static_cast<size_t>(position - group * kSpan), cents);
+  }
+
+  /// Sum of positions [first, last] over the populated trees covering them.
+  static std::int64_t sum(const Trees &trees, std::int64_t first,
+                          std::int64_t last) {
+    std::int64_t total = 0;
+    const std::int64_t lastGroup = groupOf(last);
+    for (auto it = trees.lower_bound(groupOf(first));
+         it != trees.end() && it->first <= lastGroup; ++it) {
+      const std::int64_t base = it->first * kSpan;
+      const std::int64_t from = std::max(first, base);
+      const std::int64_t to = std::min(last, base + kSpan - 1);
+      total += it->second.range(static_cast<size_t>(from - base),
+                                static_cast<size_t>(to - base));
+    }
+    return total;
+  }
+
+  static void add(Series &series, std::int64_t day, std::int64_t cents) {
+    add(series.days, day, cents);
+    add(series.blocks, groupOf(day), cents);
+  }
+
+  void apply(const models::Expense &e, std::int64_t sign) {
+    auto day = dates::dayNumber(e.getDate());
+    if (!day) {
+      return;
+    }
+    const std::int64_t cents = std::llround(e.getAmount() * 100) * sign;
+    add(overall_, *day, cents);
+    add(byCategory_[e.getCategory()], *day, cents);
+  }
+};
+} // namespace rollups
+
+namespace dedup {
+/**
+ * @brief 64-bit key identifying "the same expense" across imports
+ *
+ * Built from the trimmed, lower-cased title, the amount in cents, the
+ * category and the day of the date (the raw text when it does not parse),
+ * so the same row exported with a different date layout still matches.
+ * Indexes keep only this fingerprint, trading an ~n^2/2^65 collision
+ * chance for constant memory per row.
+ */
+inline std::uint64_t fingerprint(const models::Expense &e) {
+  std::string key = fuzzy::normalize(e.getTitle());
+  key += '\x1f';
+  key += std::to_string(std::llround(e.getAmount() * 100));
+  key += '\x1f';
+  key += e.getCategory();
+  key += '\x1f';
+  auto day = dates::dayNumber(e.getDate());
+  key += day ? std::to_string(*day) : e.getDate();
+  return sketches::hash64(key);
+}
+} // namespace dedup
+
+namespace fuzzy {
+/**
+ * @brief Dictionary of the distinct titles and categories in a repository,
+ * with the rows holding each
+ *
+ * Fuzzy queries compute edit distances against distinct normalised
+ * strings only, then read the matching rows off their postings, so no row
+ * is examined unless it matches. Rows are positions in the in-memory
+ * repository; each term's postings are kept sorted, with a row listed twice
+ * when its title and category coincide. Postings grow with the row count,
+ * so the disk store keeps them in its page file instead (see
+ * BPlusTreeExpenseRepository).
+ */
+class ExpenseTerms {
+public:
+  using Row = std::uint64_t;
+
+  void add(const models::Expense &e, Row row) {
+    link(normalize(e.getTitle()), row);
+    link(normalize(e.getCategory()), row);
+  }
+  void remove(const models::Expense &e, Row row) {
+    unlink(normalize(e.getTitle()), row);
+    unlink(normalize(e.getCategory()), row);
+  }
+  void clear() {
+    tree_.clear();
+    postings_.clear();
+  }
+
+  /// Rows whose title or category is within @p maxDistance edits of
+  /// @p query, in ascending order.
+  std::vector<Row> match(const std::string &query, size_t maxDistance) const {
+    std::vector<Row> rows;
+    for (const auto &m : tree_.search(normalize(query), maxDistance)) {
+      const auto &postings = postings_.at(m.term);
+      rows.insert(rows.end(), postings.begin(), postings.end());
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+  }
+
+private:
+  BkTree tree_;
+  std::unordered_map<std::string, std::vector<Row>> postings_;
+
+  void link(std::string term, Row row) {
+    auto &postings = postings_[term];
+    postings.insert(std::upper_bound(postings.begin(), postings.end(), row),
+                    row);
+    tree_.add(term);
+  }
+  void unlink(std::string term, Row row) {
+    auto it = postings_.find(term);
+    if (it == postings_.end()) {
+      return;
+    }
+    auto &postings = it->second;
+    auto at = std::lower_bound(postings.begin(), postings.end(), row);
+    if (at != postings.end() && *at == row) {
+      postings.erase(at);
+      tree_.remove(term);
+    }
+    if (postings.empty()) {
+      postings_.erase(it);
+    }
+  }
+};
+} // namespace fuzzy
+
 namespace repositories {
+namespace csv {
+/**
+ * @brief Writes CSV rows produced by @p writeRows to @p directory / @p filename
+ */
+inline bool writeFile(const fs::path &directory, const std::string &filename,
+                      const std::function<void(std::ostream &)> &writeRows) {
+  if (!exists(directory)) {
+    create_directory(directory);
+    std::cout << "Directory created: " << directory << std::endl;
+  }
+  fs::path filepath = directory / filename;
+  std::ofstream file(filepath);
+  if (!file.is_open()) {
+    std::cout << "Failed to open file for writing: " << filepath << std::endl;
+    return false;
+  } else {
+    writeRows(file);
+    file.close();
+  }
+  std::cout << "Expenses saved to " << filepath << std::endl;
+  return true;
+}
+
+/**
+ * @brief Problem found while loading a file
+ *
+ * File-level problems (missing directory or file) use line number 0.
+ */
+struct Diagnostic {
+  size_t lineNumber = 0;
+  std::uint64_t byteOffset = 0;
+  std::string reason;
+};
+
+enum class ErrorPolicy { FAIL_FAST, SKIP_BAD_ROWS };
+
+/**
+ * @brief What an import does with a row matching a stored expense
+ *
+ * KEEP inserts it anyway, SKIP drops it, FLAG inserts it and records a
+ * diagnostic, MERGE overwrites the stored row with the incoming one.
+ */
+enum class DuplicatePolicy { KEEP, SKIP, FLAG, MERGE };
+
+/**
+ * @brief Repository callbacks RowLoader consults before storing a row
+ *
+ * @p unstorable rejects rows the repository cannot hold; @p contains and
+ * @p replace apply a DuplicatePolicy.
+ */
+struct RowHooks {
+  std::function<std::optional<std::string>(const models::Expense &)>
+      unstorable;
+  std::function<bool(const models::Expense &)> contains;
+  /// Returns the stored row it overwrote, std::nullopt if none matched.
+  std::function<std::optional<models::Expense>(const models::Expense &)>
+      replace;
+};
+
+/**
+ * @brief How readFile() reacts to bad rows and reports progress
+ *
+ * The default load is quiet: nothing is printed per row and problems are
+ * only collected in LoadResult. @p verbose restores the per-line console
+ * log, @p onProgress fires every @p progressInterval loaded rows.
+ */
+struct LoadOptions {
+  ErrorPolicy policy = ErrorPolicy::FAIL_FAST;
+  DuplicatePolicy duplicates = DuplicatePolicy::KEEP;
+  bool append = false; // keep the current expenses instead of replacing them
+  bool verbose = false;
+  size_t progressInterval = 0;
+  std::function<void(size_t rowsLoaded)> onProgress;
+  size_t maxDiagnostics = 1000;
+  /// Sees every row the load stores as it is applied: @p before is null
+  /// for an insert and the overwritten row for a MERGE.
+  std::function<void(const models::Expense *before,
+                     const models::Expense *after)>
+      onRowApplied;
+};
+
+struct LoadResult {
+  bool ok = false;
+  size_t linesRead = 0;
+  size_t rowsLoaded = 0;
+  size_t rowsSkipped = 0;
+  size_t duplicates = 0;
+  /// Common length of every line (newline included) for fixed-width
+  /// files, 0 otherwise.
+  size_t lineWidth = 0;
+  /// Bytes up to the end of the last line read; an unterminated last line
+  /// left unread (see readFile()) is not counted.
+  std::uint64_t bytesRead = 0;
+  std::vector<Diagnostic> diagnostics;
+};
+
+/// Diagnostic text for a line models::Expense::fromCsv() rejected.
+inline std::string parseError(const std::string &line) {
+  return "Failed to parse '" + line +
+         "', expected \"title\",amount,\"category\",\"date\"";
+}
+
+/**
+ * @brief Applies LoadOptions to CSV lines one at a time
+ *
+ * Shared by readFile() and by followed files, which are fed line by line
+ * as they grow. Counters and diagnostics accumulate in the LoadResult.
+ */
+class RowLoader {
+public:
+  enum class Outcome { LOADED, DROPPED, FAILED };
+
+  RowLoader(LoadResult &result, const LoadOptions &options,
+            std::function<void(models::Expense &&)> sink,
+            RowHooks hooks = {})
+      : result_(result), options_(options), sink_(std::move(sink)),
+        hooks_(std::move(hooks)) {}
+
+  void report(size_t lineNumber, std::uint64_t offset, std::string reason) {
+    if (options_.verbose) {
+      std::cerr << (lineNumber ? "Line " + std::to_string(lineNumber) + ": "
+                               : std::string())
+                << reason << std::endl;
+    }
+    if (result_.diagnostics.size() < options_.maxDiagnostics) {
+      result_.diagnostics.push_back({lineNumber, offset, std::move(reason)});
+    }
+  }
+
+  /// FAILED means the row did not parse and the policy is FAIL_FAST.
+  Outcome consume(std::string line, size_t lineNumber, std::uint64_t offset) {
+    ++result_.linesRead;
+    // Trim whitespace for better validation
+    line.erase(0, line.find_first_not_of(" \t\r\n"));
+    line.erase(line.find_last_not_of(" \t\r\n") + 1);
+
+    if (line.empty()) {
+      if (options_.verbose) {
+        std::cout << "Skipping empty line " << lineNumber << std::endl;
+      }
+      return Outcome::DROPPED;
+    }
+
+    auto expenseOpt = models::Expense::fromCsv(line);
+    if (!expenseOpt.has_value()) {
+      return reject(lineNumber, offset, parseError(line));
+    }
+    return insert(std::move(*expenseOpt), lineNumber, offset);
+  }
+
+  /// Records a bad row; FAILED means the policy is FAIL_FAST.
+  Outcome reject(size_t lineNumber, std::uint64_t offset, std::string reason) {
+    report(lineNumber, offset, std::move(reason));
+    ++result_.rowsSkipped;
+    return options_.policy == ErrorPolicy::FAIL_FAST ? Outcome::FAILED
+                                                     : Outcome::DROPPED;
+  }
+
+  /// Hands a parsed row to the sink, applying the duplicate policy; rows
+  /// the repository cannot store are bad rows.
+  Outcome insert(models::Expense &&expense, size_t lineNumber,
+                 std::uint64_t offset) {
+    if (hooks_.unstorable) {
+      if (auto reason = hooks_.unstorable(expense)) {
+        return reject(lineNumber, offset, std::move(*reason));
+      }
+    }
+    if (options_.verbose) {
+      std::cout << "Line " << lineNumber << ": Successfully parsed expense '"
+                << expense.getTitle() << "'\n";
+    }
+    if (options_.duplicates != DuplicatePolicy::KEEP && hooks_.contains &&
+        hooks_.contains(expense)) {
+      ++result_.duplicates;
+      if (options_.duplicates == DuplicatePolicy::FLAG) {
+        report(lineNumber, offset,
+               "Duplicate of a stored expense '" + expense.getTitle() + "'");
+      } else {
+        if (options_.duplicates == DuplicatePolicy::MERGE) {
+          auto replaced = hooks_.replace(expense);
+          if (replaced && options_.onRowApplied) {
+            options_.onRowApplied(&*replaced, &expense);
+          }
+        }
+        return Outcome::DROPPED;
+      }
+    }
+    if (options_.onRowApplied) {
+      options_.onRowApplied(nullptr, &expense);
+    }
+    sink_(std::move(expense));
+    ++result_.rowsLoaded;
+    if (options_.onProgress && options_.progressInterval &&
+        result_.rowsLoaded % options_.progressInterval == 0) {
+      options_.onProgress(result_.rowsLoaded);
+    }
+    return Outcome::LOADED;
+  }
+
+private:
+  LoadResult &result_;
+  const LoadOptions &options_;
+  std::function<void(models::Expense &&)> sink_;
+  RowHooks hooks_;
+};
+
+/// Whether @p line, read without a newline, already holds a whole row. Rows
+/// end with the date's closing quote, so a row cut short while it is being
+/// written never parses.
+inline bool completeRow(std::string line) {
+  line.erase(0, line.find_first_not_of(" \t\r"));
+  line.erase(line.find_last_not_of(" \t\r") + 1);
+  return !line.empty() && models::Expense::fromCsv(line).has_value();
+}
+
+/**
+ * @brief Parses @p directory / @p filename and hands each expense to @p sink
+ *
+ * @p onOpen runs once the file is known to be readable, before the first row,
+ * so repositories can drop their previous content only when loading can start.
+ * A last line without a newline is read only when it is a whole row;
+ * anything else there may still be being written, so it is left out of
+ * linesRead and bytesRead for tail::FileFollower to pick up once its newline
+ * arrives.
+ */
+inline LoadResult readFile(const fs::path &directory,
+                           const std::string &filename,
+                           const std::function<void()> &onOpen,
+                           const std::function<void(models::Expense &&)> &sink,
+                           const LoadOptions &options = {},
+                           const RowHooks &hooks = {}) {
+  LoadResult result;
+  RowLoader loader{result, options, sink, hooks};
+
+  if (!exists(directory)) {
+    loader.report(0, 0, "Directory does not exist: " + directory.string());
+    return result;
+  }
+  fs::path filepath = directory / filename;
+  if (!exists(filepath)) {
+    loader.report(0, 0, "File does not exist: " + filepath.string());
+    return result;
+  }
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    loader.report(0, 0, "Failed to open file for reading: " +
+                            filepath.string());
+    return result;
+  }
+
+  onOpen();
+  std::string line;
+  std::uint64_t offset = 0;
+  size_t width = 0;
+  bool fixedWidth = true;
+  while (std::getline(file, line)) {
+    if (file.eof() && !completeRow(line)) {
+      break;
+    }
+    const std::uint64_t lineOffset = offset;
+    offset += line.size() + (file.eof() ? 0 : 1);
+    if (width == 0) {
+      width = line.size() + 1;
+    }
+    // row numbers must keep matching line numbers
+    fixedWidth &= line.size() + 1 == width;
+    auto outcome = loader.consume(std::move(line), result.linesRead + 1,
+                                  lineOffset);
+    if (outcome == RowLoader::Outcome::FAILED) {
+      return result;
+    }
+    fixedWidth &= outcome == RowLoader::Outcome::LOADED;
+  }
+  result.bytesRead = offset;
+  if (fixedWidth && fs::file_size(filepath) == result.linesRead * width) {
+    result.lineWidth = width;
+  }
+  result.ok = true;
+  return result;
+}
+} // namespace csv
+
 /**
  * @brief Handles expense storage and retrieval (Repository pattern)
  */
@@ -173,38 +833,187 @@ class ExpenseRepository {
   // Calss Interfaces
 public:
   using ExpenseList = std::vector<models::Expense>;
+  /// Returns false to stop a forEach() early.
+  using Visitor = std::function<bool(const models::Expense &)>;
   virtual ~ExpenseRepository() = default;
 
   virtual void addExpense(const models::Expense &e) = 0;
   virtual void updateExpense(size_t index, const models::Expense &e) = 0;
   virtual void removeExpense(size_t index) = 0;
-  virtual const ExpenseList &getAllExpenses() const = 0;
+  virtual std::optional<models::Expense> getExpense(size_t index) const = 0;
+  /// Copy of every expense; prefer forEach() where the rows are only read.
+  virtual ExpenseList getAllExpenses() const = 0;
+  /// Calls @p visit for each expense in index order without materialising
+  /// the list.
+  virtual void forEach(const Visitor &visit) const = 0;
   virtual ExpenseList
   getExpensesByCategory(const std::string &category) const = 0;
+  /**
+   * @brief Expenses dated within [from, to], oldest first
+   *
+   * A bare "YYYY-MM-DD" upper bound covers that whole day. Dates that cannot
+   * be parsed sort first and are only returned for an unparseable lower bound.
+   */
+  virtual ExpenseList getExpensesByDateRange(const std::string &from,
+                                             const std::string &to) const = 0;
   virtual ExpenseList searchExpenses(const std::string &query) const = 0;
+  /// Expenses whose title or category is within @p maxDistance edits of
+  /// @p query, ignoring case.
+  virtual ExpenseList fuzzySearchExpenses(const std::string &query,
+                                          size_t maxDistance) const = 0;
   virtual bool saveToFile(const std::string &filename) const = 0;
   virtual bool loadFromFile(const std::string &filename) = 0;
+  virtual csv::LoadResult loadFromFile(const std::string &filename,
+                                       const csv::LoadOptions &options) = 0;
+  /**
+   * @brief Appends CSV @p lines read from a followed file; @p options.append
+   * is implied
+   *
+   * Shared by every backend so followed rows are parsed, deduplicated and
+   * counted alike. An idle poll (no lines) or a batch that stored nothing
+   * does not reach commitRows().
+   */
+  csv::LoadResult appendLines(const std::vector<tail::Line> &lines,
+                              const csv::LoadOptions &options) {
+    csv::LoadResult result;
+    result.ok = true;
+    if (lines.empty()) {
+      return result;
+    }
+    csv::RowLoader loader{
+        result, options, [this](models::Expense &&e) { addExpense(e); },
+        rowHooks()};
+    for (const auto &line : lines) {
+      if (loader.consume(line.text, line.number, line.offset) ==
+          csv::RowLoader::Outcome::FAILED) {
+        result.ok = false;
+        break;
+      }
+      result.bytesRead = line.offset + line.text.size() + 1;
+    }
+    if (result.rowsLoaded || result.duplicates) {
+      commitRows();
+    }
+    return result;
+  }
+  /// storageError(), containsDuplicate() and replaceDuplicate(), for
+  /// csv::RowLoader.
+  csv::RowHooks rowHooks() {
+    return {[this](const models::Expense &e) { return storageError(e); },
+            [this](const models::Expense &e) { return containsDuplicate(e); },
+            [this](const models::Expense &e) { return replaceDuplicate(e); }};
+  }
+  /// Where following @p filename resumes; clear() forgets every position.
+  virtual tail::Position
+  getFollowPosition(const std::string &filename) const = 0;
+  virtual void setFollowPosition(const std::string &filename,
+                                 const tail::Position &position) = 0;
   virtual void clear() = 0;
   virtual size_t size() const = 0;
+  /// Why @p e cannot be stored here, std::nullopt when it can.
+  virtual std::optional<std::string>
+  storageError(const models::Expense &e) const = 0;
+  virtual const stats::ExpenseSketches &getSketches() const = 0;
+  virtual const rollups::DailyTotals &getDailyTotals() const = 0;
+  /// Whether a stored expense has the same dedup::fingerprint() as @p e.
+  virtual bool containsDuplicate(const models::Expense &e) const = 0;
+  /// Overwrites the stored duplicate of @p e with @p e and returns the row
+  /// it replaced, std::nullopt if none.
+  virtual std::optional<models::Expense>
+  replaceDuplicate(const models::Expense &e) = 0;
+
+protected:
+  /// Makes the rows stored by a load or appendLines() durable.
+  virtual void commitRows() = 0;
+  /// dates::sortKey() bounds of getExpensesByDateRange().
+  static std::pair<std::int64_t, std::int64_t>
+  dateRangeKeys(const std::string &from, const std::string &to) {
+    std::int64_t hi = dates::sortKey(to);
+    if (hi % 1000000 == 0) {
+      hi += 235959;
+    }
+    return {dates::sortKey(from), hi};
+  }
 };
 
 class InMemoryExpenseRepository : public ExpenseRepository {
   /**
    * @brief In-memory implementation of ExpenseRepository
+   *
+   * Files are written with every CSV line space-padded to one slot width
+   * (the loader trims the padding), so a later save to the same file only
+   * rewrites the slots of records changed since the last save: updated rows,
+   * appended rows and, after a removal, the shifted tail. A full rewrite is
+   * used whenever that is not safe: another target file, a file changed
+   * behind our back, or an edited row that outgrew its slot.
+   *
+   * Statistics sketches follow every add and are written next to the saved
+   * file as <filename>.sketch, stamped with the size and modification time
+   * of the CSV. Loading a whole file does not feed them row by row: the
+   * sidecar is read instead when it covers exactly the loaded rows of an
+   * unchanged file, otherwise they are rebuilt on the first query.
    */
 public:
-  void addExpense(const models::Expense &e) override { expenses_.push_back(e); }
+  void addExpense(const models::Expense &e) override {
+    expenses_.push_back(e);
+    indexDuplicate(e, expenses_.size() - 1);
+    totals_.add(e);
+    if (!termsStale_) {
+      terms_.add(e, expenses_.size() - 1);
+    }
+    if (!sketchesStale_) {
+      sketches_.add(e);
+    }
+  }
   void updateExpense(size_t index, const models::Expense &e) override {
     if (index < expenses_.size()) {
+      totals_.remove(expenses_[index]);
+      totals_.add(e);
+      if (!termsStale_) {
+        terms_.remove(expenses_[index], index);
+        terms_.add(e, index);
+      }
+      auto oldKey = dedup::fingerprint(expenses_[index]);
+      if (oldKey != dedup::fingerprint(e)) {
+        auto it = duplicateIndex_.find(oldKey);
+        // another row may share the old key; let the next lookup rebuild
+        duplicateIndexStale_ |=
+            it != duplicateIndex_.end() && it->second == index;
+      }
       expenses_[index] = e;
+      indexDuplicate(e, index);
+      dirtyRows_.insert(index);
+      sketchesStale_ = true;
     }
   }
   void removeExpense(size_t index) override {
     if (index < expenses_.size()) {
+      totals_.remove(expenses_[index]);
+      if (index + 1 == expenses_.size()) {
+        terms_.remove(expenses_[index], index);
+      } else {
+        termsStale_ = true; // postings after index shifted
+      }
       expenses_.erase(expenses_.begin() + index);
+      shiftedFrom_ = std::min(shiftedFrom_, index);
+      duplicateIndexStale_ = true; // positions after index shifted
+      sketchesStale_ = true;
+    }
+  }
+  std::optional<models::Expense> getExpense(size_t index) const override {
+    if (index >= expenses_.size()) {
+      return std::nullopt;
+    }
+    return expenses_[index];
+  }
+  ExpenseList getAllExpenses() const override { return expenses_; }
+  void forEach(const Visitor &visit) const override {
+    for (const auto &e : expenses_) {
+      if (!visit(e)) {
+        return;
+      }
     }
   }
-  const ExpenseList &getAllExpenses() const override { return expenses_; }
   ExpenseList
   getExpensesByCategory(const std::string &category) const override {
     ExpenseList filtered;
@@ -215,6 +1024,24 @@ public:
                  });
     return filtered;
   }
+  ExpenseList getExpensesByDateRange(const std::string &from,
+                                     const std::string &to) const override {
+    const auto [lo, hi] = dateRangeKeys(from, to);
+    std::vector<std::pair<std::int64_t, size_t>> keyed;
+    for (size_t i = 0; i < expenses_.size(); ++i) {
+      std::int64_t key = dates::sortKey(expenses_[i].getDate());
+      if (key >= lo && key <= hi) {
+        keyed.emplace_back(key, i);
+      }
+    }
+    std::sort(keyed.begin(), keyed.end());
+    ExpenseList results;
+    results.reserve(keyed.size());
+    for (const auto &[key, i] : keyed) {
+      results.push_back(expenses_[i]);
+    }
+    return results;
+  }
   ExpenseList searchExpenses(const std::string &query) const override {
     ExpenseList results;
     std::copy_if(expenses_.begin(), expenses_.end(),
@@ -226,86 +1053,1673 @@ public:
 
     return results;
   }
-  bool saveToFile(const std::string &filename) const override {
-
-    if (!exists(directory_path)) {
-      create_directory(directory_path);
-      std::cout << "Directory created: " << directory_path << std::endl;
+  /// Postings hold row positions, so the first search after removing a
+  /// row other than the last one rebuilds them.
+  ExpenseList fuzzySearchExpenses(const std::string &query,
+                                  size_t maxDistance) const override {
+    if (termsStale_) {
+      terms_.clear();
+      for (size_t i = 0; i < expenses_.size(); ++i) {
+        terms_.add(expenses_[i], i);
+      }
+      termsStale_ = false;
     }
+    ExpenseList results;
+    for (auto row : terms_.match(query, maxDistance)) {
+      results.push_back(expenses_[row]);
+    }
+    return results;
+  }
+  bool saveToFile(const std::string &filename) const override {
     fs::path filepath = directory_path / filename;
-    std::ofstream file(filepath);
-    if (!file.is_open()) {
-      std::cout << "Failed to open file for writing: " << filepath << std::endl;
-      return false;
-    } else {
+    bool saved = saveIncrementally(filepath);
+    if (!saved) {
+      size_t longest = 0;
       for (const auto &e : expenses_) {
-        file << e.toCsv() << "\n";
+        longest = std::max(longest, e.toCsv().size());
+      }
+      // leave a little headroom so small edits keep fitting their slot
+      size_t slotWidth = (longest + kSlotHeadroom + 1 + 7) / 8 * 8;
+      saved = csv::writeFile(directory_path, filename, [&](std::ostream &out) {
+        for (const auto &e : expenses_) {
+          out << padToSlot(e.toCsv(), slotWidth);
+        }
+      });
+      if (saved) {
+        markSaved(filepath, slotWidth);
       }
-      file.close();
     }
-    std::cout << "Expenses saved to " << filepath << std::endl;
-    return true;
+    if (saved) {
+      // a stale sketch file would describe rows that no longer exist
+      fs::path sketchPath = filepath.string() + ".sketch";
+      if (sketchesStale_) {
+        std::error_code ec;
+        fs::remove(sketchPath, ec);
+      } else {
+        sketches_.saveToFile(sketchPath, filepath);
+      }
+    }
+    return saved;
   }
   bool loadFromFile(const std::string &filename) override {
-    std::string line;
-    size_t lineNumber = 0;
-    std::optional<models::Expense> results;
-    if (!exists(directory_path)) {
-      std::cout << "Directory does not exist: " << directory_path << std::endl;
-      return false;
+    return loadFromFile(filename, csv::LoadOptions{}).ok;
+  }
+  csv::LoadResult loadFromFile(const std::string &filename,
+                               const csv::LoadOptions &options) override {
+    auto result = csv::readFile(
+        directory_path, filename,
+        [this, &options]() {
+          if (!options.append) {
+            clear();
+            sketchesStale_ = true; // restored from the sidecar below
+          }
+        },
+        [this](models::Expense &&e) { addExpense(e); }, options,
+        rowHooks());
+    if (result.ok && !options.append) {
+      fs::path filepath = directory_path / filename;
+      auto persisted =
+          stats::ExpenseSketches::loadFromFile(filepath.string() + ".sketch",
+                                               filepath);
+      if (persisted && persisted->rows() == expenses_.size()) {
+        sketches_ = std::move(*persisted);
+        sketchesStale_ = false;
+      }
+      if (result.lineWidth > 0) {
+        markSaved(filepath, result.lineWidth);
+      }
     }
-    fs::path filepath = directory_path / filename;
-    if (!exists(filepath)) {
-      std::cout << "File does not exist: " << filepath << std::endl;
-      return false;
+    return result;
+  }
+  tail::Position
+  getFollowPosition(const std::string &filename) const override {
+    auto it = followPositions_.find(filename);
+    return it == followPositions_.end() ? tail::Position{} : it->second;
+  }
+  void setFollowPosition(const std::string &filename,
+                         const tail::Position &position) override {
+    followPositions_[filename] = position;
+  }
+  std::optional<std::string>
+  storageError(const models::Expense &) const override {
+    return std::nullopt;
+  }
+  void clear() override {
+    expenses_.clear();
+    followPositions_.clear();
+    shiftedFrom_ = 0;
+    sketches_.clear();
+    sketchesStale_ = false;
+    totals_.clear();
+    terms_.clear();
+    termsStale_ = false;
+    duplicateIndex_.clear();
+    duplicateIndexStale_ = false;
+  }
+  size_t size() const override { return expenses_.size(); }
+  const stats::ExpenseSketches &getSketches() const override {
+    if (sketchesStale_) {
+      sketches_.clear();
+      for (const auto &e : expenses_) {
+        sketches_.add(e);
+      }
+      sketchesStale_ = false;
     }
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-      std::cout << "Failed to open file for reading: " << filepath << std::endl;
-      return false;
-    } else {
-      clear();
-      while (std::getline(file, line)) {
-        ++lineNumber;
+    return sketches_;
+  }
+  const rollups::DailyTotals &getDailyTotals() const override {
+    return totals_;
+  }
+  bool containsDuplicate(const models::Expense &e) const override {
+    return findDuplicate(e).has_value();
+  }
+  std::optional<models::Expense>
+  replaceDuplicate(const models::Expense &e) override {
+    auto index = findDuplicate(e);
+    if (!index) {
+      return std::nullopt;
+    }
+    models::Expense replaced = expenses_[*index];
+    updateExpense(*index, e);
+    return replaced;
+  }
 
-        // Trim whitespace for better validation
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+protected:
+  void commitRows() override {} // rows are only written by saveToFile()
 
-        if (line.empty()) {
-          std::cout << "Skipping empty line " << lineNumber << std::endl;
-          continue;
-        }
+private:
+  static constexpr size_t kSlotHeadroom = 8;
 
-        auto expenseOpt = models::Expense::fromCsv(line);
-        if (expenseOpt.has_value()) {
-          expenses_.push_back(std::move(*expenseOpt));
-          std::cout << "Line " << lineNumber
-                    << ": Successfully parsed expense '"
-                    << expenseOpt->getTitle() << "'" << std::endl;
-        } else {
-          std::cerr << "Line " << lineNumber << ": Failed to parse '" << line
-                    << "'" << std::endl;
-
-          // Optional: Show expected format
-          std::cerr << "Expected format: \"title\",amount,\"category\",\"date\""
-                    << std::endl;
-          return false;
-        }
-      }
-    }
+  /**
+   * @brief Layout of the file last written or loaded in fixed-width form
+   */
+  struct SavedLayout {
+    fs::path file;
+    size_t slotWidth = 0;
+    size_t rows = 0;
+    fs::file_time_type writeTime;
+  };
+
+  ExpenseList expenses_;
+  const fs::path directory_path = "./data_store";
+  mutable SavedLayout saved_;
+  mutable std::set<size_t> dirtyRows_;
+  mutable size_t shiftedFrom_ = 0;
+  mutable stats::ExpenseSketches sketches_;
+  mutable bool sketchesStale_ = false;
+  rollups::DailyTotals totals_;
+  mutable fuzzy::ExpenseTerms terms_;
+  mutable bool termsStale_ = false;
+  // file -> where following it resumes
+  std::map<std::string, tail::Position> followPositions_;
+  // fingerprint -> position of the first row with that key
+  mutable std::unordered_map<std::uint64_t, size_t> duplicateIndex_;
+  mutable bool duplicateIndexStale_ = false;
+
+  void indexDuplicate(const models::Expense &e, size_t index) const {
+    if (!duplicateIndexStale_) {
+      duplicateIndex_.emplace(dedup::fingerprint(e), index);
+    }
+  }
+
+  std::optional<size_t> findDuplicate(const models::Expense &e) const {
+    if (duplicateIndexStale_) {
+      duplicateIndex_.clear();
+      duplicateIndexStale_ = false;
+      for (size_t i = 0; i < expenses_.size(); ++i) {
+        indexDuplicate(expenses_[i], i);
+      }
+    }
+    auto it = duplicateIndex_.find(dedup::fingerprint(e));
+    if (it == duplicateIndex_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  static std::string padToSlot(const std::string &line, size_t slotWidth) {
+    std::string slot = line;
+    slot.resize(slotWidth - 1, ' ');
+    slot.push_back('\n');
+    return slot;
+  }
+
+  void markSaved(const fs::path &filepath, size_t slotWidth) const {
+    saved_.file = filepath;
+    saved_.slotWidth = slotWidth;
+    saved_.rows = expenses_.size();
+    saved_.writeTime = fs::last_write_time(filepath);
+    dirtyRows_.clear();
+    shiftedFrom_ = expenses_.size();
+  }
+
+  /**
+   * @brief Rewrites only the slots changed since the last save
+   *
+   * Returns false without touching the file when a full rewrite is needed.
+   */
+  bool saveIncrementally(const fs::path &filepath) const {
+    std::error_code ec;
+    if (saved_.slotWidth == 0 || saved_.file != filepath ||
+        fs::file_size(filepath, ec) != saved_.rows * saved_.slotWidth || ec ||
+        fs::last_write_time(filepath, ec) != saved_.writeTime) {
+      return false;
+    }
+    size_t tailFrom = std::min({shiftedFrom_, saved_.rows, expenses_.size()});
+    std::vector<size_t> rows;
+    for (auto row : dirtyRows_) {
+      if (row < tailFrom) {
+        rows.push_back(row);
+      }
+    }
+    for (size_t row = tailFrom; row < expenses_.size(); ++row) {
+      rows.push_back(row);
+    }
+    std::vector<std::string> lines;
+    lines.reserve(rows.size());
+    for (auto row : rows) {
+      lines.push_back(expenses_[row].toCsv());
+      if (lines.back().size() >= saved_.slotWidth) {
+        return false; // edited row outgrew its slot
+      }
+    }
+
+    std::fstream file(filepath, std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+      return false;
+    }
+    for (size_t i = 0; i < rows.size(); ++i) {
+      file.seekp(static_cast<std::streamoff>(rows[i] * saved_.slotWidth));
+      file << padToSlot(lines[i], saved_.slotWidth);
+    }
     file.close();
+    if (!file) {
+      return false;
+    }
+    if (expenses_.size() < saved_.rows) {
+      fs::resize_file(filepath, expenses_.size() * saved_.slotWidth);
+    }
+    markSaved(filepath, saved_.slotWidth);
+    std::cout << "Expenses saved to " << filepath << " (" << rows.size()
+              << " of " << expenses_.size() << " rows rewritten)" << std::endl;
     return true;
   }
-  void clear() override { expenses_.clear(); }
-  size_t size() const override { return expenses_.size(); }
+};
+
+class BPlusTreeExpenseRepository : public ExpenseRepository {
+  /**
+   * @brief Disk-resident implementation backed by a page-based B+tree file
+   *
+   * Records live in data_store/<filename> keyed by a stable ID, with
+   * secondary (date, ID), (fingerprint, ID) and (term hash, ID) indexes. Only @p cachePages pages are held in memory;
+   * positional access goes through the per-child counts of the ID tree, so
+   * point operations are O(log n) whatever the size of the history. A record
+   * must fit a quarter of a page (about 1 KiB with 4 KiB pages); larger
+   * expenses are refused through storageError() before anything is written.
+   * Nothing but the pages is cached: forEach() and the queries decode rows
+   * as they scan, and only getAllExpenses() materialises the whole list.
+   * Statistics sketches are kept in <filename>.sketch and trusted on reopen
+   * only when they cover exactly the stored rows and the store file has not
+   * changed since they were written. Follow positions are kept
+   * in <filename>.follow, so following a file after a restart resumes where
+   * the stored rows end instead of ingesting it again.
+   */
+public:
+  explicit BPlusTreeExpenseRepository(std::string filename = "expenses.bpt",
+                                      size_t cachePages = 256,
+                                      size_t pageSize = 4096)
+      : filepath_{prepareFile(directory_path, filename)},
+        pager_{filepath_, pageSize, cachePages},
+        records_{pager_, kRecordsRoot, kRecordsSize},
+        byDate_{pager_, kDateRoot, kDateSize},
+        byFingerprint_{pager_, kFingerprintRoot, kFingerprintSize},
+        byTerm_{pager_, kTermRoot, kTermSize} {
+    if (byFingerprint_.size() != records_.size()) {
+      // stores written before the fingerprint index existed
+      records_.scan([this](const std::uint64_t &id, const std::string &value) {
+        auto key = dedup::fingerprint(decode(value));
+        byFingerprint_.insert(DuplicateKey{key, id}, {});
+        return true;
+      });
+    }
+    auto persisted =
+        stats::ExpenseSketches::loadFromFile(sketchPath(), filepath_);
+    if (persisted && persisted->rows() == records_.size()) {
+      sketches_ = std::move(*persisted);
+    } else {
+      sketchesStale_ = records_.size() > 0;
+    }
+    totalsStale_ = records_.size() > 0;
+    termsStale_ = totalsStale_;
+    if (byTerm_.size() != 2 * records_.size()) {
+      // stores written before the term index existed
+      records_.scan([this](const std::uint64_t &id, const std::string &value) {
+        indexTerms(decode(value), id);
+        return true;
+      });
+    }
+    loadFollowPositions();
+  }
+  ~BPlusTreeExpenseRepository() override {
+    try {
+      commitRows(); // the sidecar is stamped with the flushed file
+    } catch (...) {
+    }
+  }
+
+  void addExpense(const models::Expense &e) override {
+    std::uint64_t id = pager_.meta(kNextId);
+    records_.insert(id, encode(e));
+    byDate_.insert(DateKey{dates::sortKey(e.getDate()), id}, {});
+    byFingerprint_.insert(DuplicateKey{dedup::fingerprint(e), id}, {});
+    indexTerms(e, id);
+    pager_.setMeta(kNextId, id + 1);
+    if (!totalsStale_) {
+      totals_.add(e);
+    }
+    if (!sketchesStale_) {
+      sketches_.add(e);
+    }
+  }
+  void updateExpense(size_t index, const models::Expense &e) override {
+    auto entry = records_.nth(index);
+    if (entry) {
+      updateRecord(entry->first, decode(entry->second), e);
+    }
+  }
+  void removeExpense(size_t index) override {
+    auto entry = records_.nth(index);
+    if (entry) {
+      auto old = decode(entry->second);
+      byDate_.erase(DateKey{dates::sortKey(old.getDate()), entry->first});
+      records_.erase(entry->first);
+      byFingerprint_.erase(DuplicateKey{dedup::fingerprint(old), entry->first});
+      unindexTerms(old, entry->first);
+      if (!totalsStale_) {
+        totals_.remove(old);
+      }
+      markSketchesStale();
+    }
+  }
+  std::optional<models::Expense> getExpense(size_t index) const override {
+    auto entry = records_.nth(index);
+    if (!entry) {
+      return std::nullopt;
+    }
+    return decode(entry->second);
+  }
+  ExpenseList getAllExpenses() const override {
+    ExpenseList all;
+    all.reserve(records_.size());
+    forEach([&all](const models::Expense &e) {
+      all.push_back(e);
+      return true;
+    });
+    return all;
+  }
+  void forEach(const Visitor &visit) const override {
+    records_.scan([&visit](const std::uint64_t &, const std::string &value) {
+      return visit(decode(value));
+    });
+  }
+  ExpenseList
+  getExpensesByCategory(const std::string &category) const override {
+    ExpenseList filtered;
+    records_.scan([&](const std::uint64_t &, const std::string &value) {
+      auto e = decode(value);
+      if (e.getCategory() == category) {
+        filtered.push_back(std::move(e));
+      }
+      return true;
+    });
+    return filtered;
+  }
+  ExpenseList searchExpenses(const std::string &query) const override {
+    ExpenseList results;
+    records_.scan([&](const std::uint64_t &, const std::string &value) {
+      auto e = decode(value);
+      if (e.getTitle().find(query) != std::string::npos ||
+          e.getCategory().find(query) != std::string::npos) {
+        results.push_back(std::move(e));
+      }
+      return true;
+    });
+    return results;
+  }
+  /// Only the distinct normalised titles and categories stay in memory, in
+  /// a BK-tree the first fuzzy search after reopening rebuilds with one
+  /// scan. Matching terms are resolved to IDs through the (term hash, ID)
+  /// index in the store file, so only the matching records are read.
+  ExpenseList fuzzySearchExpenses(const std::string &query,
+                                  size_t maxDistance) const override {
+    if (termsStale_) {
+      terms_.clear();
+      records_.scan([this](const std::uint64_t &, const std::string &value) {
+        auto e = decode(value);
+        terms_.add(fuzzy::normalize(e.getTitle()));
+        terms_.add(fuzzy::normalize(e.getCategory()));
+        return true;
+      });
+      termsStale_ = false;
+    }
+    std::unordered_set<std::string> matched;
+    std::vector<std::uint64_t> ids;
+    for (auto &m : terms_.search(fuzzy::normalize(query), maxDistance)) {
+      const TermKey from{sketches::hash64(m.term), 0};
+      byTerm_.scan(
+          [&](const TermKey &key, const std::string &) {
+            if (key.hash != from.hash) {
+              return false;
+            }
+            ids.push_back(key.slot / 2);
+            return true;
+          },
+          &from);
+      matched.insert(std::move(m.term));
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    ExpenseList results;
+    for (auto id : ids) {
+      auto value = records_.find(id);
+      if (!value) {
+        continue;
+      }
+      auto e = decode(*value);
+      // hashes may collide: keep rows whose own terms matched
+      if (matched.count(fuzzy::normalize(e.getTitle())) ||
+          matched.count(fuzzy::normalize(e.getCategory()))) {
+        results.push_back(std::move(e));
+      }
+    }
+    return results;
+  }
+  /// Walks the date index from @p from, so only matching rows are decoded.
+  ExpenseList getExpensesByDateRange(const std::string &from,
+                                     const std::string &to) const override {
+    ExpenseList results;
+    const auto bounds = dateRangeKeys(from, to);
+    const DateKey lo{bounds.first, 0};
+    const std::int64_t hi = bounds.second;
+    byDate_.scan(
+        [&](const DateKey &key, const std::string &) {
+          if (key.date > hi) {
+            return false;
+          }
+          if (auto value = records_.find(key.id)) {
+            results.push_back(decode(*value));
+          }
+          return true;
+        },
+        &lo);
+    return results;
+  }
+  bool saveToFile(const std::string &filename) const override {
+    pager_.flush();
+    persistSketches();
+    return csv::writeFile(directory_path, filename, [this](std::ostream &out) {
+      records_.scan([&out](const std::uint64_t &, const std::string &value) {
+        out << decode(value).toCsv() << "\n";
+        return true;
+      });
+    });
+  }
+  bool loadFromFile(const std::string &filename) override {
+    return loadFromFile(filename, csv::LoadOptions{}).ok;
+  }
+  csv::LoadResult loadFromFile(const std::string &filename,
+                               const csv::LoadOptions &options) override {
+    auto result = csv::readFile(
+        directory_path, filename,
+        [this, &options]() {
+          if (!options.append) {
+            clear();
+          }
+        },
+        [this](models::Expense &&e) { addExpense(e); }, options,
+        rowHooks());
+    commitRows();
+    return result;
+  }
+  tail::Position
+  getFollowPosition(const std::string &filename) const override {
+    auto it = followPositions_.find(filename);
+    return it == followPositions_.end() ? tail::Position{} : it->second;
+  }
+  void setFollowPosition(const std::string &filename,
+                         const tail::Position &position) override {
+    followPositions_[filename] = position;
+    saveFollowPositions();
+  }
+  void clear() override {
+    pager_.reset();
+    records_.clear();
+    byDate_.clear();
+    byFingerprint_.clear();
+    byTerm_.clear();
+    sketches_.clear();
+    sketchesStale_ = false;
+    totals_.clear();
+    totalsStale_ = false;
+    terms_.clear();
+    termsStale_ = false;
+    followPositions_.clear();
+    std::error_code ec;
+    fs::remove(followPath(), ec);
+  }
+  size_t size() const override { return records_.size(); }
+  /// A record must fit a B+tree leaf entry, so the page size bounds it.
+  std::optional<std::string>
+  storageError(const models::Expense &e) const override {
+    const size_t size = encodedSize(e);
+    if (size > records_.maxValueSize()) {
+      return "Expense '" + e.getTitle().substr(0, 32) + "' needs " +
+             std::to_string(size) + " bytes; the disk store holds at most " +
+             std::to_string(records_.maxValueSize()) + " per expense";
+    }
+    return std::nullopt;
+  }
+  const stats::ExpenseSketches &getSketches() const override {
+    if (sketchesStale_) {
+      sketches_.clear();
+      records_.scan([this](const std::uint64_t &, const std::string &value) {
+        sketches_.add(decode(value));
+        return true;
+      });
+      sketchesStale_ = false;
+    }
+    return sketches_;
+  }
+  /// Rollups are not persisted; the first query after reopening rebuilds
+  /// them with one scan.
+  const rollups::DailyTotals &getDailyTotals() const override {
+    if (totalsStale_) {
+      totals_.clear();
+      records_.scan([this](const std::uint64_t &, const std::string &value) {
+        totals_.add(decode(value));
+        return true;
+      });
+      totalsStale_ = false;
+    }
+    return totals_;
+  }
+  bool containsDuplicate(const models::Expense &e) const override {
+    return findDuplicate(e).has_value();
+  }
+  std::optional<models::Expense>
+  replaceDuplicate(const models::Expense &e) override {
+    auto id = findDuplicate(e);
+    if (!id) {
+      return std::nullopt;
+    }
+    auto replaced = decode(*records_.find(*id));
+    updateRecord(*id, replaced, e);
+    return replaced;
+  }
+
+protected:
+  void commitRows() override {
+    pager_.flush();
+    persistSketches();
+  }
 
 private:
-  ExpenseList expenses_;
+  struct DateKey {
+    std::int64_t date;
+    std::uint64_t id;
+    bool operator<(const DateKey &other) const {
+      return date != other.date ? date < other.date : id < other.id;
+    }
+  };
+  struct DuplicateKey {
+    std::uint64_t fingerprint;
+    std::uint64_t id;
+    bool operator<(const DuplicateKey &other) const {
+      return fingerprint != other.fingerprint
+                 ? fingerprint < other.fingerprint
+                 : id < other.id;
+    }
+  };
+  // slot is ID * 2 for the title's term, ID * 2 + 1 for the category's
+  struct TermKey {
+    std::uint64_t hash;
+    std::uint64_t slot;
+    bool operator<(const TermKey &other) const {
+      return hash != other.hash ? hash < other.hash : slot < other.slot;
+    }
+  };
+  // Pager metadata slots
+  static constexpr size_t kRecordsRoot = 0;
+  static constexpr size_t kRecordsSize = 1;
+  static constexpr size_t kDateRoot = 2;
+  static constexpr size_t kDateSize = 3;
+  static constexpr size_t kNextId = 4;
+  static constexpr size_t kFingerprintRoot = 5;
+  static constexpr size_t kFingerprintSize = 6;
+  static constexpr size_t kTermRoot = 7;
+  static constexpr size_t kTermSize = 8;
+
   const fs::path directory_path = "./data_store";
+  const fs::path filepath_;
+  mutable storage::Pager pager_;
+  storage::BPlusTree<std::uint64_t> records_;
+  storage::BPlusTree<DateKey> byDate_;
+  storage::BPlusTree<DuplicateKey> byFingerprint_;
+  storage::BPlusTree<TermKey> byTerm_;
+  mutable stats::ExpenseSketches sketches_;
+  mutable bool sketchesStale_ = false;
+  mutable rollups::DailyTotals totals_;
+  mutable bool totalsStale_ = false;
+  mutable fuzzy::BkTree terms_; // distinct terms only
+  mutable bool termsStale_ = false;
+  std::map<std::string, tail::Position> followPositions_;
+
+  std::optional<std::uint64_t> findDuplicate(const models::Expense &e) const {
+    std::optional<std::uint64_t> found;
+    const DuplicateKey from{dedup::fingerprint(e), 0};
+    byFingerprint_.scan(
+        [&](const DuplicateKey &key, const std::string &) {
+          if (key.fingerprint == from.fingerprint) {
+            found = key.id;
+          }
+          return false;
+        },
+        &from);
+    return found;
+  }
+
+  void updateRecord(std::uint64_t id, const models::Expense &old,
+                    const models::Expense &e) {
+    byDate_.erase(DateKey{dates::sortKey(old.getDate()), id});
+    byFingerprint_.erase(DuplicateKey{dedup::fingerprint(old), id});
+    records_.insert(id, encode(e));
+    byDate_.insert(DateKey{dates::sortKey(e.getDate()), id}, {});
+    byFingerprint_.insert(DuplicateKey{dedup::fingerprint(e), id}, {});
+    if (!totalsStale_) {
+      totals_.remove(old);
+      totals_.add(e);
+    }
+    unindexTerms(old, id);
+    indexTerms(e, id);
+    markSketchesStale();
+  }
+
+  void indexTerms(const models::Expense &e, std::uint64_t id) {
+    auto title = fuzzy::normalize(e.getTitle());
+    auto category = fuzzy::normalize(e.getCategory());
+    byTerm_.insert(TermKey{sketches::hash64(title), id * 2}, {});
+    byTerm_.insert(TermKey{sketches::hash64(category), id * 2 + 1}, {});
+    if (!termsStale_) {
+      terms_.add(title);
+      terms_.add(category);
+    }
+  }
+  void unindexTerms(const models::Expense &e, std::uint64_t id) {
+    auto title = fuzzy::normalize(e.getTitle());
+    auto category = fuzzy::normalize(e.getCategory());
+    byTerm_.erase(TermKey{sketches::hash64(title), id * 2});
+    byTerm_.erase(TermKey{sketches::hash64(category), id * 2 + 1});
+    if (!termsStale_) {
+      terms_.remove(title);
+      terms_.remove(category);
+    }
+  }
+
+  fs::path sketchPath() const { return filepath_.string() + ".sketch"; }
+  fs::path followPath() const { return filepath_.string() + ".follow"; }
+
+  // One "file",offset,inode,lines line per followed file
+  void saveFollowPositions() const {
+    std::ofstream file(followPath(), std::ios::trunc);
+    for (const auto &[name, position] : followPositions_) {
+      file << std::quoted(name) << "," << position.offset << ","
+           << position.inode << "," << position.lines << "\n";
+    }
+  }
+  void loadFollowPositions() {
+    std::ifstream file(followPath());
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream ss{line};
+      std::string name;
+      tail::Position position;
+      char comma = 0;
+      if (ss >> std::quoted(name) >> comma >> position.offset >> comma >>
+          position.inode >> comma >> position.lines) {
+        followPositions_[name] = position;
+      }
+    }
+  }
+
+  void persistSketches() const {
+    if (!sketchesStale_) {
+      sketches_.saveToFile(sketchPath(), filepath_);
+    }
+  }
+
+  // Sketches cannot forget rows, so the persisted copy must not outlive them
+  void markSketchesStale() {
+    if (!sketchesStale_) {
+      std::error_code ec;
+      fs::remove(sketchPath(), ec);
+      sketchesStale_ = true;
+    }
+  }
+
+  static fs::path prepareFile(const fs::path &directory,
+                              const std::string &filename) {
+    if (!exists(directory)) {
+      create_directory(directory);
+      std::cout << "Directory created: " << directory << std::endl;
+    }
+    return directory / filename;
+  }
+
+  static size_t encodedSize(const models::Expense &e) {
+    return sizeof(double) + 3 * sizeof(std::uint16_t) + e.getTitle().size() +
+           e.getCategory().size() + e.getDate().size();
+  }
+
+  static std::string encode(const models::Expense &e) {
+    std::string out;
+    double amount = e.getAmount();
+    out.append(reinterpret_cast<const char *>(&amount), sizeof(amount));
+    for (const auto *field : {&e.getTitle(), &e.getCategory(), &e.getDate()}) {
+      if (field->size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::length_error("Expense field too long for B+tree record");
+      }
+      std::uint16_t len = static_cast<std::uint16_t>(field->size());
+      out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+      out.append(*field);
+    }
+    return out;
+  }
+
+  static models::Expense decode(const std::string &value) {
+    double amount = 0.0;
+    std::memcpy(&amount, value.data(), sizeof(amount));
+    size_t pos = sizeof(amount);
+    std::string fields[3];
+    for (auto &field : fields) {
+      std::uint16_t len = 0;
+      std::memcpy(&len, value.data() + pos, sizeof(len));
+      pos += sizeof(len);
+      field = value.substr(pos, len);
+      pos += len;
+    }
+    return models::Expense(std::move(fields[0]), amount, std::move(fields[1]),
+                           std::move(fields[2]));
+  }
 };
 } // namespace repositories
 
+namespace archive {
+/**
+ * @brief Filter applied while reading an archive
+ *
+ * Empty fields are unbounded. A bare "YYYY-MM-DD" upper bound covers that
+ * whole day. Blocks whose min/max date or category set cannot match are
+ * skipped without being decoded.
+ */
+struct Query {
+  std::string from;
+  std::string to;
+  std::string category;
+};
+
+struct ReadStats {
+  size_t blocksRead = 0;
+  size_t blocksSkipped = 0;
+  size_t rows = 0;
+  size_t duplicates = 0;
+};
+
+namespace detail {
+constexpr char kMagic[8] = {'E', 'X', 'P', 'A', 'R', 'C', '0', '1'};
+constexpr size_t kBlockRows = 4096;
+
+// Low two bits of every entry in the date column
+enum DateLayout : std::uint64_t { ISO_DATE, ISO_DATETIME, CTIME, RAW };
+
+inline void putFrame(std::ostream &out, const std::string &first,
+                     const std::string &second) {
+  std::uint32_t sizes[2] = {static_cast<std::uint32_t>(first.size()),
+                            static_cast<std::uint32_t>(second.size())};
+  out.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+  out << first << second;
+}
+
+inline bool getFrame(std::istream &in, std::string &first,
+                     std::string &second) {
+  std::uint32_t sizes[2];
+  if (!in.read(reinterpret_cast<char *>(sizes), sizeof(sizes))) {
+    return false;
+  }
+  first.resize(sizes[0]);
+  second.resize(sizes[1]);
+  return static_cast<bool>(in.read(first.data(), sizes[0]) &&
+                           in.read(second.data(), sizes[1]));
+}
+
+inline std::optional<std::int64_t> epochBound(const std::string &date,
+                                              bool upper) {
+  auto t = dates::parse(date);
+  if (!t) {
+    return std::nullopt;
+  }
+  std::int64_t seconds = dates::toEpochSeconds(*t);
+  if (upper && dates::formatIsoDate(*t) == date) {
+    seconds += 86399;
+  }
+  return seconds;
+}
+} // namespace detail
+
+namespace detail {
+/// Encodes one block of rows and writes it as a frame.
+inline void putBlock(std::ostream &file,
+                     const std::vector<models::Expense> &rows,
+                     const std::map<std::string, std::uint64_t> &dictionary) {
+  using codec::putVarint;
+  std::string dateColumn, amountColumn, categoryColumn, titles;
+  std::int64_t previous = 0;
+  std::int64_t minDate = std::numeric_limits<std::int64_t>::max();
+  std::int64_t maxDate = std::numeric_limits<std::int64_t>::min();
+  std::vector<std::uint64_t> present;
+
+  for (const auto &e : rows) {
+    const std::string &date = e.getDate();
+    auto parsed = dates::parse(date);
+    auto layout = RAW;
+    std::int64_t seconds = 0;
+    if (parsed) {
+      // compare with what the reader will rebuild, so dates that normalise
+      // differently ("2025-02-30", a leap second) are stored raw
+      seconds = dates::toEpochSeconds(*parsed);
+      const auto decoded = dates::fromEpochSeconds(seconds);
+      if (dates::formatIsoDate(decoded) == date) {
+        layout = ISO_DATE;
+      } else if (dates::formatIsoDateTime(decoded) == date) {
+        layout = ISO_DATETIME;
+      } else if (dates::formatCtime(decoded) == date) {
+        layout = CTIME;
+      }
+    }
+    if (layout == RAW) {
+      putVarint(dateColumn, RAW);
+      putVarint(dateColumn, date.size());
+      dateColumn += date;
+    } else {
+      putVarint(dateColumn, codec::zigzag(seconds - previous) << 2 | layout);
+      previous = seconds;
+      minDate = std::min(minDate, seconds);
+      maxDate = std::max(maxDate, seconds);
+    }
+
+    std::int64_t cents = std::llround(e.getAmount() * 100);
+    bool exact = static_cast<double>(cents) / 100 == e.getAmount();
+    putVarint(amountColumn, codec::zigzag(cents) << 1 | exact);
+    if (!exact) {
+      double amount = e.getAmount();
+      amountColumn.append(reinterpret_cast<const char *>(&amount),
+                          sizeof(amount));
+    }
+
+    const std::uint64_t categoryId = dictionary.at(e.getCategory());
+    putVarint(categoryColumn, categoryId);
+    if (std::find(present.begin(), present.end(), categoryId) ==
+        present.end()) {
+      present.push_back(categoryId);
+    }
+
+    putVarint(titles, e.getTitle().size());
+    titles += e.getTitle();
+  }
+
+  std::string stats;
+  putVarint(stats, rows.size());
+  putVarint(stats, codec::zigzag(minDate));
+  putVarint(stats, codec::zigzag(maxDate));
+  putVarint(stats, present.size());
+  for (auto id : present) {
+    putVarint(stats, id);
+  }
+  std::string payload = dateColumn + amountColumn + categoryColumn;
+  std::string compressed = codec::compress(titles);
+  putVarint(payload, titles.size());
+  putVarint(payload, compressed.size());
+  payload += compressed;
+  putFrame(file, stats, payload);
+}
+} // namespace detail
+
+/**
+ * @brief Writes the expenses of @p repository to a columnar archive
+ *
+ * Rows are cut into blocks of detail::kBlockRows. Within a block dates are
+ * delta-encoded epoch seconds tagged with their original layout, amounts are
+ * varint cents (raw doubles only when cents would lose precision),
+ * categories index a file-level dictionary and titles are LZ-compressed.
+ * The repository is scanned twice, once for the dictionary and once for the
+ * blocks, so only one block of rows is held in memory.
+ */
+inline bool writeFile(const fs::path &directory, const std::string &filename,
+                      const repositories::ExpenseRepository &repository) {
+  using codec::putVarint;
+  if (!exists(directory)) {
+    create_directory(directory);
+    std::cout << "Directory created: " << directory << std::endl;
+  }
+  fs::path filepath = directory / filename;
+  std::ofstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "Failed to open file for writing: " << filepath << std::endl;
+    return false;
+  }
+
+  std::map<std::string, std::uint64_t> dictionary;
+  std::string header;
+  size_t rowCount = 0;
+  repository.forEach([&](const models::Expense &e) {
+    auto [it, inserted] =
+        dictionary.emplace(e.getCategory(), dictionary.size());
+    if (inserted) {
+      putVarint(header, e.getCategory().size());
+      header += e.getCategory();
+    }
+    ++rowCount;
+    return true;
+  });
+  file.write(detail::kMagic, sizeof(detail::kMagic));
+  std::string counts;
+  putVarint(counts, dictionary.size());
+  putVarint(counts, rowCount);
+  detail::putFrame(file, counts, header);
+
+  std::vector<models::Expense> block;
+  block.reserve(std::min(rowCount, detail::kBlockRows));
+  repository.forEach([&](const models::Expense &e) {
+    block.push_back(e);
+    if (block.size() == detail::kBlockRows) {
+      detail::putBlock(file, block, dictionary);
+      block.clear();
+    }
+    return true;
+  });
+  if (!block.empty()) {
+    detail::putBlock(file, block, dictionary);
+  }
+  if (!file) {
+    std::cout << "Failed to write archive: " << filepath << std::endl;
+    return false;
+  }
+  std::cout << "Archive written to " << filepath << std::endl;
+  return true;
+}
+
+/**
+ * @brief Streams the rows of an archive matching @p query into @p sink
+ *
+ * Only one block is held in memory at a time. Returns std::nullopt when the
+ * file is missing or malformed.
+ */
+inline std::optional<ReadStats>
+readFile(const fs::path &directory, const std::string &filename,
+         const Query &query,
+         const std::function<void(models::Expense &&)> &sink) {
+  fs::path filepath = directory / filename;
+  if (!exists(filepath)) {
+    std::cout << "File does not exist: " << filepath << std::endl;
+    return std::nullopt;
+  }
+  std::ifstream file(filepath, std::ios::binary);
+  char magic[sizeof(detail::kMagic)] = {};
+  std::string counts, header;
+  if (!file.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), detail::kMagic) ||
+      !detail::getFrame(file, counts, header)) {
+    std::cout << "Not an expense archive: " << filepath << std::endl;
+    return std::nullopt;
+  }
+
+  ReadStats result;
+  try {
+    codec::Reader countReader{counts.data(), counts.size()};
+    codec::Reader headerReader{header.data(), header.size()};
+    std::vector<std::string> categories(countReader.varint());
+    for (auto &category : categories) {
+      category = headerReader.bytes();
+    }
+    auto from = detail::epochBound(query.from, false);
+    auto to = detail::epochBound(query.to, true);
+    bool dateBounded = !query.from.empty() || !query.to.empty();
+    std::optional<std::uint64_t> categoryId;
+    if (!query.category.empty()) {
+      auto it = std::find(categories.begin(), categories.end(), query.category);
+      if (it == categories.end()) {
+        return result; // no block can contain it
+      }
+      categoryId = it - categories.begin();
+    }
+    auto dateMatches = [&](std::int64_t lo, std::int64_t hi) {
+      return !dateBounded || ((!from || hi >= *from) && (!to || lo <= *to));
+    };
+
+    std::string stats, payload;
+    std::uint32_t sizes[2];
+    while (file.read(reinterpret_cast<char *>(sizes), sizeof(sizes))) {
+      stats.resize(sizes[0]);
+      if (!file.read(stats.data(), sizes[0])) {
+        throw std::runtime_error("Truncated block header");
+      }
+      codec::Reader statsReader{stats.data(), stats.size()};
+      size_t rows = statsReader.varint();
+      std::int64_t minDate = statsReader.svarint();
+      std::int64_t maxDate = statsReader.svarint();
+      bool skip = minDate > maxDate ? dateBounded
+                                    : !dateMatches(minDate, maxDate);
+      if (categoryId) {
+        bool present = false;
+        for (size_t n = statsReader.varint(); n > 0; --n) {
+          present |= statsReader.varint() == *categoryId;
+        }
+        skip |= !present;
+      }
+      if (skip) {
+        file.seekg(sizes[1], std::ios::cur);
+        ++result.blocksSkipped;
+        continue;
+      }
+      payload.resize(sizes[1]);
+      if (!file.read(payload.data(), sizes[1])) {
+        throw std::runtime_error("Truncated block payload");
+      }
+      ++result.blocksRead;
+
+      codec::Reader in{payload.data(), payload.size()};
+      std::vector<std::string> blockDates(rows);
+      std::vector<bool> datedRow(rows, false);
+      std::vector<std::int64_t> seconds(rows, 0);
+      std::int64_t previous = 0;
+      for (size_t row = 0; row < rows; ++row) {
+        std::uint64_t entry = in.varint();
+        auto layout = static_cast<detail::DateLayout>(entry & 3);
+        if (layout == detail::RAW) {
+          blockDates[row] = in.bytes();
+          continue;
+        }
+        previous += codec::unzigzag(entry >> 2);
+        auto civil = dates::fromEpochSeconds(previous);
+        blockDates[row] = layout == detail::ISO_DATE
+                              ? dates::formatIsoDate(civil)
+                          : layout == detail::ISO_DATETIME
+                              ? dates::formatIsoDateTime(civil)
+                              : dates::formatCtime(civil);
+        datedRow[row] = true;
+        seconds[row] = previous;
+      }
+      std::vector<double> amounts(rows);
+      for (auto &amount : amounts) {
+        std::uint64_t entry = in.varint();
+        amount = entry & 1 ? static_cast<double>(codec::unzigzag(entry >> 1)) /
+                                 100
+                           : in.fixed<double>();
+      }
+      std::vector<std::uint64_t> ids(rows);
+      for (auto &id : ids) {
+        id = in.varint();
+        if (id >= categories.size()) {
+          throw std::runtime_error("Unknown category id");
+        }
+      }
+      size_t rawSize = in.varint();
+      size_t compressedSize = in.varint();
+      std::string titles =
+          codec::decompress(in.take(compressedSize), compressedSize, rawSize);
+      codec::Reader titleReader{titles.data(), titles.size()};
+
+      for (size_t row = 0; row < rows; ++row) {
+        std::string title = titleReader.bytes();
+        if (categoryId && ids[row] != *categoryId) {
+          continue;
+        }
+        if (dateBounded &&
+            (!datedRow[row] || !dateMatches(seconds[row], seconds[row]))) {
+          continue;
+        }
+        ++result.rows;
+        sink(models::Expense(std::move(title), amounts[row],
+                             categories[ids[row]], std::move(blockDates[row])));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cout << "Corrupt archive " << filepath << ": " << e.what()
+              << std::endl;
+    return std::nullopt;
+  }
+  return result;
+}
+} // namespace archive
+
+namespace importer {
+namespace csv = repositories::csv;
+
+/**
+ * @brief Work and waiting done by one pipeline stage
+ *
+ * @p items is bytes for the reader and rows for the other stages.
+ * @p busySeconds sums the time its threads spent working, so
+ * items / busySeconds is the rate the stage could sustain on its own.
+ * @p outputFullWaits counts pushes that found the next queue full
+ * (backpressure from downstream); @p inputEmptyWaits counts pops that found
+ * the previous queue empty (starved by upstream).
+ */
+struct StageStats {
+  std::string name;
+  size_t threads = 1;
+  std::uint64_t items = 0;
+  double busySeconds = 0.0;
+  std::uint64_t outputFullWaits = 0;
+  std::uint64_t inputEmptyWaits = 0;
+};
+
+struct ImportStats {
+  double seconds = 0.0;
+  std::uint64_t bytes = 0;
+  std::vector<StageStats> stages; // reader, parse, validate, insert
+};
+
+constexpr size_t kMaxParserThreads = 64;
+
+/**
+ * @brief Pipeline tuning; chunkBytes and queueDepth must be positive
+ */
+struct Options {
+  // 0: one per hardware thread left over; capped at kMaxParserThreads
+  size_t parserThreads = 0;
+  size_t chunkBytes = 1 << 20;
+  size_t queueDepth = 8; // chunks in flight between two stages
+};
+
+namespace detail {
+/// Lines read as one unit of work, cut at a newline.
+struct Chunk {
+  size_t sequence = 0;
+  size_t firstLine = 1;
+  std::uint64_t offset = 0;
+  std::string text;
+};
+
+struct Row {
+  std::optional<models::Expense> expense;
+  std::string error; // set when the row is rejected
+  size_t lineNumber = 0;
+  std::uint64_t offset = 0;
+};
+
+struct Rows {
+  size_t sequence = 0;
+  size_t lines = 0; // blank ones included
+  std::vector<Row> rows;
+};
+
+class Stopwatch {
+public:
+  explicit Stopwatch(double &total) : total_(total) {}
+  ~Stopwatch() {
+    total_ += std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - start_)
+                  .count();
+  }
+
+private:
+  double &total_;
+  std::chrono::steady_clock::time_point start_ =
+      std::chrono::steady_clock::now();
+};
+} // namespace detail
+
+/**
+ * @brief Loads a CSV file through a reader -> parsers -> validator ->
+ * writer pipeline
+ *
+ * The reader cuts the file into newline-aligned chunks; parser threads
+ * turn them into expenses with models::Expense::fromCsv(); one validator
+ * applies ExpenseValidator; the calling thread is the single writer and
+ * hands rows to @p sink in file order, through csv::RowLoader so error
+ * and duplicate policies behave as in csv::readFile(). Stages are joined
+ * by bounded lock-free queues (MPMC around the parsers, SPSC into the
+ * writer). Parsers finish out of order, so the reader also stays within a
+ * window of chunks past the one the writer waits for; memory is bounded by
+ * that window whatever the size of the file. Unlike readFile() rows that
+ * fail validation are rejected too.
+ */
+inline ImportStats run(const fs::path &filepath,
+                       const csv::LoadOptions &options,
+                       const Options &tuning,
+                       const std::function<void()> &onOpen,
+                       const std::function<void(models::Expense &&)> &sink,
+                       const csv::RowHooks &hooks,
+                       csv::LoadResult &result) {
+  using detail::Chunk;
+  using detail::Rows;
+  using detail::Stopwatch;
+  const auto started = std::chrono::steady_clock::now();
+  ImportStats stats;
+  result = {};
+  csv::RowLoader loader{result, options, sink, hooks};
+
+  if (tuning.chunkBytes == 0 || tuning.queueDepth == 0) {
+    loader.report(0, 0, "Import chunk size and queue depth must be positive");
+    return stats;
+  }
+  if (!exists(filepath)) {
+    loader.report(0, 0, "File does not exist: " + filepath.string());
+    return stats;
+  }
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    loader.report(0, 0, "Failed to open file for reading: " +
+                            filepath.string());
+    return stats;
+  }
+  onOpen();
+
+  const size_t hardware = std::thread::hardware_concurrency(); // 0: unknown
+  const size_t parsers =
+      tuning.parserThreads ? std::min(tuning.parserThreads, kMaxParserThreads)
+      : hardware > 1       ? hardware - 1
+                           : 1;
+  // chunks the reader may run ahead of the writer: every queue full plus
+  // one per parser, so the window only binds when the writer falls behind
+  const size_t window = tuning.queueDepth * 3 + parsers;
+  stats.stages = {{"read", 1}, {"parse", parsers}, {"validate", 1},
+                  {"insert", 1}};
+  auto &reading = stats.stages[0];
+  auto &parsing = stats.stages[1];
+  auto &validating = stats.stages[2];
+  auto &inserting = stats.stages[3];
+
+  std::atomic<bool> cancelled{false};
+  pipeline::Link<Chunk, pipeline::MpmcQueue> chunks{tuning.queueDepth, 1,
+                                                    cancelled};
+  pipeline::Link<Rows, pipeline::MpmcQueue> parsed{tuning.queueDepth, parsers,
+                                                   cancelled};
+  pipeline::Link<Rows, pipeline::SpscQueue> validated{tuning.queueDepth, 1,
+                                                      cancelled};
+  std::vector<double> parseBusy(parsers, 0.0);
+  std::vector<std::uint64_t> parseRows(parsers, 0);
+  std::atomic<size_t> written{0}; // chunks the writer has inserted
+  std::uint64_t windowWaits = 0;
+
+  std::vector<std::thread> threads;
+  // Stops and joins the stages however the writer leaves
+  struct Joiner {
+    std::atomic<bool> &cancelled;
+    std::vector<std::thread> &threads;
+    ~Joiner() {
+      cancelled = true;
+      for (auto &t : threads) {
+        if (t.joinable()) {
+          t.join();
+        }
+      }
+    }
+  } joiner{cancelled, threads};
+
+  threads.emplace_back([&] {
+    Chunk chunk;
+    std::string carry;
+    std::vector<char> buffer(tuning.chunkBytes);
+    size_t line = 1;
+    std::uint64_t offset = 0;
+    while (true) {
+      {
+        Stopwatch busy{reading.busySeconds};
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const size_t got = static_cast<size_t>(file.gcount());
+        reading.items += got;
+        if (got == 0 && carry.empty()) {
+          break;
+        }
+        chunk.text = std::move(carry);
+        chunk.text.append(buffer.data(), got);
+        size_t cut = got == 0 ? chunk.text.size()
+                              : chunk.text.find_last_of('\n') + 1;
+        if (got > 0 && cut == 0) {
+          carry = std::move(chunk.text); // a line longer than one read
+          continue;
+        }
+        carry = chunk.text.substr(cut);
+        chunk.text.resize(cut);
+        chunk.firstLine = line;
+        chunk.offset = offset;
+        line += std::count(chunk.text.begin(), chunk.text.end(), '\n');
+        offset += cut;
+      }
+      unsigned spins = 0;
+      while (chunk.sequence - written.load(std::memory_order_acquire) >=
+                 window &&
+             !cancelled.load(std::memory_order_relaxed)) {
+        windowWaits += spins == 0;
+        pipeline::detail::backoff(spins);
+      }
+      size_t next = chunk.sequence + 1;
+      if (!chunks.push(std::move(chunk))) {
+        break;
+      }
+      chunk = {};
+      chunk.sequence = next;
+    }
+    chunks.producerDone();
+  });
+
+  for (size_t worker = 0; worker < parsers; ++worker) {
+    threads.emplace_back([&, worker] {
+      Chunk chunk;
+      while (chunks.pop(chunk)) {
+        Rows out;
+        {
+          Stopwatch busy{parseBusy[worker]};
+          out.sequence = chunk.sequence;
+          std::uint64_t offset = chunk.offset;
+          size_t lineNumber = chunk.firstLine;
+          for (size_t start = 0; start < chunk.text.size(); ++lineNumber) {
+            size_t end = chunk.text.find('\n', start);
+            if (end == std::string::npos) {
+              end = chunk.text.size();
+            }
+            std::string line = chunk.text.substr(start, end - start);
+            const std::uint64_t lineOffset = offset;
+            offset += end - start + 1;
+            start = end + 1;
+            ++out.lines;
+            line.erase(0, line.find_first_not_of(" \t\r\n"));
+            line.erase(line.find_last_not_of(" \t\r\n") + 1);
+            if (line.empty()) {
+              continue;
+            }
+            detail::Row row;
+            row.lineNumber = lineNumber;
+            row.offset = lineOffset;
+            row.expense = models::Expense::fromCsv(line);
+            if (!row.expense) {
+              row.error = csv::parseError(line);
+            }
+            out.rows.push_back(std::move(row));
+          }
+          parseRows[worker] += out.rows.size();
+        }
+        if (!parsed.push(std::move(out))) {
+          break;
+        }
+      }
+      parsed.producerDone();
+    });
+  }
+
+  threads.emplace_back([&] {
+    const validator::ExpenseValidator validator;
+    Rows batch;
+    while (parsed.pop(batch)) {
+      {
+        Stopwatch busy{validating.busySeconds};
+        for (auto &row : batch.rows) {
+          if (!row.expense) {
+            continue;
+          }
+          auto verdict = validator.validate(*row.expense);
+          if (verdict !=
+              validator::ExpenseValidator::ValidationResult::SUCCESS) {
+            row.error = "Rejected '" + row.expense->getTitle() +
+                        "': " + validator.getErrorMessage(verdict);
+            row.expense.reset();
+          }
+        }
+        validating.items += batch.rows.size();
+      }
+      if (!validated.push(std::move(batch))) {
+        break;
+      }
+    }
+    validated.producerDone();
+  });
+
+  // Single writer: restores file order, then inserts
+  std::map<size_t, Rows> early;
+  size_t expected = 0;
+  bool failed = false;
+  Rows batch;
+  while (!failed && validated.pop(batch)) {
+    early.emplace(batch.sequence, std::move(batch));
+    for (auto next = early.find(expected); next != early.end() && !failed;
+         next = early.find(++expected)) {
+      Stopwatch busy{inserting.busySeconds};
+      Rows ready = std::move(next->second);
+      early.erase(next);
+      result.linesRead += ready.lines;
+      for (auto &row : ready.rows) {
+        auto outcome =
+            row.expense
+                ? loader.insert(std::move(*row.expense), row.lineNumber,
+                                row.offset)
+                : loader.reject(row.lineNumber, row.offset,
+                                std::move(row.error));
+        if (outcome == csv::RowLoader::Outcome::FAILED) {
+          failed = true;
+          break;
+        }
+        inserting.items += outcome == csv::RowLoader::Outcome::LOADED;
+      }
+      written.store(expected + 1, std::memory_order_release);
+    }
+  }
+  cancelled = failed;
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (size_t worker = 0; worker < parsers; ++worker) {
+    parsing.busySeconds += parseBusy[worker];
+    parsing.items += parseRows[worker];
+  }
+  reading.outputFullWaits = chunks.fullWaits() + windowWaits;
+  parsing.inputEmptyWaits = chunks.emptyWaits();
+  parsing.outputFullWaits = parsed.fullWaits();
+  validating.inputEmptyWaits = parsed.emptyWaits();
+  validating.outputFullWaits = validated.fullWaits();
+  inserting.inputEmptyWaits = validated.emptyWaits();
+  stats.bytes = reading.items;
+  result.bytesRead = reading.items;
+  result.ok = !failed && !file.bad();
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - started)
+                      .count();
+  return stats;
+}
+} // namespace importer
+
+namespace budget {
+/**
+ * @brief Monthly spending limit for one category
+ */
+struct Budget {
+  std::string category;
+  double limit = 0.0;
+  int warnPercent = 80; // warn once a month reaches this share of the limit
+};
+
+/**
+ * @brief A category's month that just reached a budget threshold
+ */
+struct Alert {
+  std::string category;
+  std::string month; // "YYYY-MM"
+  double spent = 0.0;
+  double limit = 0.0;
+  bool exceeded = false; // over the limit, not just past the warning share
+};
+
+/**
+ * @brief Per-(category, month) spend counters checked against budgets
+ *
+ * Only budgeted categories are counted, in integer cents keyed by
+ * year * 12 + month - 1, so applying a mutation and checking its
+ * thresholds is a couple of hash lookups whatever the history size.
+ * Alerts fire when a month moves up a level (below, warning, exceeded);
+ * a month that drops back alerts again on the next crossing. Expenses
+ * whose date cannot be parsed are not counted.
+ */
+class BudgetTracker {
+public:
+  using ExpenseList = std::vector<models::Expense>;
+
+  const std::map<std::string, Budget> &budgets() const noexcept {
+    return budgets_;
+  }
+  bool empty() const noexcept { return budgets_.empty(); }
+
+  /// Adds or replaces a budget, counting its category's rows in one
+  /// streaming scan of @p expenses.
+  void setBudget(const Budget &budget,
+                 const repositories::ExpenseRepository &expenses) {
+    budgets_[budget.category] = budget;
+    auto &months = spent_[budget.category];
+    months.clear();
+    expenses.forEach([&](const models::Expense &e) {
+      if (e.getCategory() == budget.category) {
+        if (auto month = monthOf(e.getDate())) {
+          months[*month] += cents(e.getAmount());
+        }
+      }
+      return true;
+    });
+  }
+  bool removeBudget(const std::string &category) {
+    spent_.erase(category);
+    return budgets_.erase(category) > 0;
+  }
+
+  /**
+   * @brief Moves @p before (if any) to @p after (if any), appending the
+   * thresholds @p after reached to @p alerts
+   */
+  void apply(const models::Expense *before, const models::Expense *after,
+             std::vector<Alert> &alerts) {
+    std::int64_t *counter = nullptr;
+    int levelBefore = 0;
+    if (after) {
+      counter = counterFor(*after);
+      levelBefore = counter ? level(after->getCategory(), *counter) : 0;
+    }
+    if (before) {
+      if (auto *old = counterFor(*before)) {
+        *old -= cents(before->getAmount());
+      }
+    }
+    if (counter) {
+      *counter += cents(after->getAmount());
+      if (level(after->getCategory(), *counter) > levelBefore) {
+        alerts.push_back(alertFor(after->getCategory(),
+                                  *monthOf(after->getDate()), *counter));
+      }
+    }
+  }
+
+  /**
+   * @brief Recounts every budgeted category in one scan of @p expenses
+   *
+   * Given @p alerts, appends one for each month that moved up a level
+   * compared with the previous counters.
+   */
+  void rebuild(const repositories::ExpenseRepository &expenses,
+               std::vector<Alert> *alerts = nullptr) {
+    auto previous = std::move(spent_);
+    spent_.clear();
+    for (const auto &[category, budget] : budgets_) {
+      spent_[category];
+    }
+    expenses.forEach([this](const models::Expense &e) {
+      if (auto *counter = counterFor(e)) {
+        *counter += cents(e.getAmount());
+      }
+      return true;
+    });
+    if (!alerts) {
+      return;
+    }
+    for (const auto &[category, months] : spent_) {
+      const auto &old = previous[category];
+      for (const auto &[month, total] : months) {
+        auto was = old.find(month);
+        int levelBefore =
+            was == old.end() ? 0 : level(category, was->second);
+        if (level(category, total) > levelBefore) {
+          alerts->push_back(alertFor(category, month, total));
+        }
+      }
+    }
+    std::sort(alerts->begin(), alerts->end(),
+              [](const Alert &a, const Alert &b) {
+                return a.month != b.month ? a.month < b.month
+                                          : a.category < b.category;
+              });
+  }
+
+  /// Spent on @p category in the month of @p date.
+  double spent(const std::string &category, const std::string &date) const {
+    auto months = spent_.find(category);
+    auto month = monthOf(date);
+    if (months == spent_.end() || !month) {
+      return 0.0;
+    }
+    auto total = months->second.find(*month);
+    return total == months->second.end() ? 0.0 : total->second / 100.0;
+  }
+
+  /// Writes one "category",limit,warnPercent line per budget.
+  bool saveToFile(const fs::path &filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+      return false;
+    }
+    for (const auto &[category, budget] : budgets_) {
+      file << std::quoted(category) << "," << budget.limit << ","
+           << budget.warnPercent << "\n";
+    }
+    return static_cast<bool>(file);
+  }
+  /// Reads budget definitions; counters start empty, see rebuild().
+  bool loadFromFile(const fs::path &filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+      return false;
+    }
+    budgets_.clear();
+    spent_.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream ss{line};
+      Budget budget;
+      char comma = 0;
+      if (ss >> std::quoted(budget.category) >> comma >> budget.limit >>
+              comma >> budget.warnPercent &&
+          budget.limit > 0) {
+        spent_[budget.category];
+        budgets_[budget.category] = std::move(budget);
+      }
+    }
+    return true;
+  }
+
+private:
+  std::map<std::string, Budget> budgets_;
+  std::unordered_map<std::string,
+                     std::unordered_map<std::int64_t, std::int64_t>>
+      spent_;
+
+  static std::int64_t cents(double amount) {
+    return std::llround(amount * 100);
+  }
+  static std::optional<std::int64_t> monthOf(const std::string &date) {
+    auto t = dates::parse(date);
+    if (!t) {
+      return std::nullopt;
+    }
+    return t->year * 12LL + t->month - 1;
+  }
+
+  std::int64_t *counterFor(const models::Expense &e) {
+    auto months = spent_.find(e.getCategory());
+    auto month = monthOf(e.getDate());
+    if (months == spent_.end() || !month) {
+      return nullptr;
+    }
+    return &months->second[*month];
+  }
+
+  int level(const std::string &category, std::int64_t total) const {
+    const Budget &budget = budgets_.at(category);
+    const std::int64_t limit = cents(budget.limit);
+    if (total > limit) {
+      return 2;
+    }
+    return total * 100 >= limit * budget.warnPercent ? 1 : 0;
+  }
+
+  Alert alertFor(const std::string &category, std::int64_t month,
+                 std::int64_t total) const {
+    dates::CivilTime t;
+    t.year = static_cast<int>(month / 12);
+    t.month = static_cast<int>(month % 12) + 1;
+    t.day = 1;
+    const double limit = budgets_.at(category).limit;
+    return {category, dates::formatIsoDate(t).substr(0, 7), total / 100.0,
+            limit, level(category, total) == 2};
+  }
+};
+} // namespace budget
+
 namespace services {
 /**
  * @brief Business logic for expense management (Service pattern)
@@ -314,7 +2728,13 @@ class ExpenseService {
 public:
   explicit ExpenseService(
       std::unique_ptr<repositories::ExpenseRepository> repository)
-      : repository_(std::move(repository)), validator_() {}
+      : repository_(std::move(repository)), validator_() {
+    // nothing was just added, so there is nothing to alert about yet
+    if (budgets_.loadFromFile(directory_path / kBudgetFile) &&
+        !budgets_.empty()) {
+      budgets_.rebuild(*repository_);
+    }
+  }
   enum class OperationResult {
     SUCCESS,
     VALIDATION_ERROR,
@@ -332,7 +2752,13 @@ public:
       lastError_ = validator_.getErrorMessage(validatorResult);
       return OperationResult::VALIDATION_ERROR;
     }
+    if (auto reason = repository_->storageError(expense)) {
+      lastError_ = *reason;
+      return OperationResult::VALIDATION_ERROR;
+    }
     repository_->addExpense(expense);
+    lastAlerts_.clear();
+    budgets_.apply(nullptr, &expense, lastAlerts_);
     return OperationResult::SUCCESS;
   }
   OperationResult updateExpense(size_t index, const std::string &title,
@@ -350,8 +2776,15 @@ public:
       lastError_ = validator_.getErrorMessage(validatorResult);
       return OperationResult::VALIDATION_ERROR;
     }
+    if (auto reason = repository_->storageError(expense)) {
+      lastError_ = *reason;
+      return OperationResult::VALIDATION_ERROR;
+    }
 
+    auto previous = repository_->getExpense(index);
     repository_->updateExpense(index, expense);
+    lastAlerts_.clear();
+    budgets_.apply(previous ? &*previous : nullptr, &expense, lastAlerts_);
     return OperationResult::SUCCESS;
   }
   OperationResult deleteExpense(size_t index) {
@@ -359,49 +2792,385 @@ public:
       lastError_ = "Index out of range!";
       return OperationResult::INDEX_OUT_OF_RANGE;
     }
-    repository_->removeExpense(index);
+    auto previous = repository_->getExpense(index);
+    repository_->removeExpense(index);
+    lastAlerts_.clear();
+    budgets_.apply(previous ? &*previous : nullptr, nullptr, lastAlerts_);
+    return OperationResult::SUCCESS;
+  }
+  repositories::ExpenseRepository::ExpenseList getAllExpenses() const {
+    return repository_->getAllExpenses();
+  }
+  void forEachExpense(
+      const repositories::ExpenseRepository::Visitor &visit) const {
+    repository_->forEach(visit);
+  }
+  size_t getExpenseCount() const { return repository_->size(); }
+  repositories::ExpenseRepository::ExpenseList
+  getExpensesByCategory(const std::string &category) const {
+    return repository_->getExpensesByCategory(category);
+  }
+  /**
+   * @brief Expenses dated from @p from to @p to (inclusive days), oldest
+   * first; std::nullopt when a bound is not a recognised date
+   */
+  std::optional<repositories::ExpenseRepository::ExpenseList>
+  getExpensesByDateRange(const std::string &from,
+                         const std::string &to) const {
+    if (!dates::parse(from) || !dates::parse(to)) {
+      return std::nullopt;
+    }
+    return repository_->getExpensesByDateRange(from, to);
+  }
+  repositories::ExpenseRepository::ExpenseList
+  searchExpenses(const std::string &query) const {
+    return repository_->searchExpenses(query);
+  }
+  /**
+   * @brief Expenses whose title or category is within @p maxDistance typos
+   * of @p query; 0 falls back to the exact substring search
+   */
+  repositories::ExpenseRepository::ExpenseList
+  searchExpenses(const std::string &query, size_t maxDistance) const {
+    if (maxDistance == 0) {
+      return repository_->searchExpenses(query);
+    }
+    return repository_->fuzzySearchExpenses(query, maxDistance);
+  }
+  double calculateTotal(const std::string &category = "") const {
+    double total = 0.0;
+    repository_->forEach([&](const models::Expense &expense) {
+      if (category.empty() || expense.getCategory() == category) {
+        total += expense.getAmount();
+      }
+      return true;
+    });
+    return total;
+  }
+  /**
+   * @brief Total spent from @p from to @p to (inclusive days)
+   *
+   * Answered from the repository's daily rollups without scanning rows
+   * (see rollups::DailyTotals). Returns std::nullopt when a bound is not a
+   * recognised date.
+   */
+  std::optional<double>
+  calculateRangeTotal(const std::string &from, const std::string &to,
+                      const std::string &category = "") const {
+    auto fromDay = dates::dayNumber(from);
+    auto toDay = dates::dayNumber(to);
+    if (!fromDay || !toDay) {
+      return std::nullopt;
+    }
+    return repository_->getDailyTotals().rangeTotal(*fromDay, *toDay,
+                                                    category);
+  }
+  OperationResult saveToFile(const std::string &filename) {
+    if (!repository_->saveToFile(filename)) {
+      lastError_ = "Cannot create file!";
+      return OperationResult::FILE_ERROR;
+    }
+    return OperationResult::SUCCESS;
+  }
+  OperationResult loadFromFile(const std::string &filename,
+                               const repositories::csv::LoadOptions &options =
+                                   {}) {
+    lastAlerts_.clear();
+    lastLoadResult_ =
+        repository_->loadFromFile(filename, withBudgetHook(options));
+    if (!options.append) {
+      rebuildBudgets();
+    }
+    if (!lastLoadResult_.ok) {
+      lastError_ = lastLoadResult_.diagnostics.empty()
+                       ? "File not exist!"
+                       : lastLoadResult_.diagnostics.front().reason;
+      return OperationResult::FILE_ERROR;
+    }
+    repository_->setFollowPosition(
+        filename, {lastLoadResult_.bytesRead,
+                   tail::inodeOf(directory_path / filename),
+                   lastLoadResult_.linesRead});
+    return OperationResult::SUCCESS;
+  }
+  /**
+   * @brief Appends rows written to data_store/@p filename as they arrive
+   *
+   * Starts after the last line taken from the same file by an earlier load
+   * or follow, so nothing is parsed twice (the repository keeps that
+   * position, across restarts for the disk store), then keeps reading newly
+   * appended complete lines (see tail::FileFollower for truncation and
+   * rotation).
+   * Each batch goes through the repository's addExpense(), so indexes,
+   * sketches and rollups stay current. @p onBatch sees every batch, empty
+   * ones included, and following stops once it returns false.
+   * getLastLoadResult() sums up the whole session.
+   */
+  OperationResult followFile(
+      const std::string &filename,
+      const repositories::csv::LoadOptions &options,
+      const std::function<bool(const repositories::csv::LoadResult &)>
+          &onBatch,
+      int pollMs = 250) {
+    if (!exists(directory_path)) {
+      lastError_ = "Directory does not exist: " + directory_path.string();
+      return OperationResult::FILE_ERROR;
+    }
+    tail::Position resumeAt = repository_->getFollowPosition(filename);
+    tail::FileFollower follower{directory_path / filename, resumeAt};
+    auto batchOptions = options;
+    batchOptions.append = true;
+    batchOptions = withBudgetHook(std::move(batchOptions));
+    lastLoadResult_ = {};
+    lastLoadResult_.ok = true;
+    std::vector<tail::Line> lines;
+    while (true) {
+      lines.clear();
+      follower.readLines(
+          [&lines](tail::Line &&line) { lines.push_back(std::move(line)); },
+          kFollowBatch);
+      lastAlerts_.clear();
+      auto batch = repository_->appendLines(lines, batchOptions);
+      lastLoadResult_.linesRead += batch.linesRead;
+      lastLoadResult_.rowsLoaded += batch.rowsLoaded;
+      lastLoadResult_.rowsSkipped += batch.rowsSkipped;
+      lastLoadResult_.duplicates += batch.duplicates;
+      for (auto &d : batch.diagnostics) {
+        if (lastLoadResult_.diagnostics.size() < options.maxDiagnostics) {
+          lastLoadResult_.diagnostics.push_back(d);
+        }
+      }
+      if (!batch.ok) {
+        // resume at the failed line once the file has been fixed
+        const auto &failed = lines[batch.linesRead - 1];
+        repository_->setFollowPosition(
+            filename,
+            {failed.offset, follower.position().inode, failed.number - 1});
+        lastLoadResult_.ok = false;
+        lastError_ = batch.diagnostics.back().reason;
+        return OperationResult::FILE_ERROR;
+      }
+      if (!(follower.position() == resumeAt)) {
+        resumeAt = follower.position();
+        repository_->setFollowPosition(filename, resumeAt);
+      }
+      if (!onBatch(batch)) {
+        break;
+      }
+      if (lines.size() < kFollowBatch) {
+        follower.wait(pollMs);
+      }
+    }
+    lastLoadResult_.bytesRead = follower.position().offset;
     return OperationResult::SUCCESS;
   }
-  const repositories::ExpenseRepository::ExpenseList &getAllExpenses() const {
-    return repository_->getAllExpenses();
+  /**
+   * @brief Appends the lines written to data_store/@p filename since it was
+   * last loaded or followed, then returns
+   *
+   * What a restart needs when the repository outlives the process: rows
+   * taken by earlier runs are not read again, and every new line is
+   * appended under @p options (repeat purchases included, with the default
+   * KEEP). A file never read before is read whole. getLastLoadResult() and
+   * getLastAlerts() cover all the lines appended.
+   */
+  OperationResult resumeFile(const std::string &filename,
+                             const repositories::csv::LoadOptions &options) {
+    if (!exists(directory_path / filename)) {
+      lastLoadResult_ = {};
+      lastAlerts_.clear();
+      lastError_ =
+          "File does not exist: " + (directory_path / filename).string();
+      return OperationResult::FILE_ERROR;
+    }
+    std::vector<budget::Alert> alerts;
+    auto result = followFile(
+        filename, options,
+        [this, &alerts](const repositories::csv::LoadResult &batch) {
+          alerts.insert(alerts.end(), lastAlerts_.begin(), lastAlerts_.end());
+          // a short batch means the end of the file was reached
+          return batch.linesRead == kFollowBatch;
+        });
+    if (result == OperationResult::SUCCESS) {
+      lastAlerts_ = std::move(alerts);
+    }
+    return result;
   }
-  repositories::ExpenseRepository::ExpenseList
-  getExpensesByCategory(const std::string &category) const {
-    return repository_->getExpensesByCategory(category);
+  const repositories::csv::LoadResult &getLastLoadResult() const {
+    return lastLoadResult_;
   }
-  repositories::ExpenseRepository::ExpenseList
-  searchExpenses(const std::string &query) const {
-    return repository_->searchExpenses(query);
+  /**
+   * @brief Loads a large external CSV through importer::run()
+   *
+   * Same options and duplicate handling as loadFromFile(), but reading,
+   * parsing and validation run on their own threads ahead of the single
+   * thread inserting into the repository. Rows failing ExpenseValidator
+   * are treated as bad rows. Stage statistics are kept for
+   * getLastImportStats().
+   */
+  OperationResult importFile(const std::string &filename,
+                             const repositories::csv::LoadOptions &options =
+                                 {},
+                             const importer::Options &tuning = {}) {
+    lastAlerts_.clear();
+    lastImportStats_ = importer::run(
+        directory_path / filename, withBudgetHook(options), tuning,
+        [this, &options]() {
+          if (!options.append) {
+            repository_->clear();
+          }
+        },
+        [this](models::Expense &&e) { repository_->addExpense(e); },
+        repository_->rowHooks(), lastLoadResult_);
+    if (!options.append) {
+      rebuildBudgets();
+    }
+    if (!lastLoadResult_.ok) {
+      lastError_ = lastLoadResult_.diagnostics.empty()
+                       ? "File not exist!"
+                       : lastLoadResult_.diagnostics.back().reason;
+      return OperationResult::FILE_ERROR;
+    }
+    return OperationResult::SUCCESS;
   }
-  double calculateTotal(const std::string &category = "") const {
-    const auto &expenses = category.empty()
-                               ? repository_->getAllExpenses()
-                               : repository_->getExpensesByCategory(category);
-    return std::accumulate(expenses.begin(), expenses.end(), 0.0,
-                           [](double sum, const models::Expense &expense) {
-                             return sum + expense.getAmount();
-                           });
+  const importer::ImportStats &getLastImportStats() const {
+    return lastImportStats_;
   }
-  OperationResult saveToFile(const std::string &filename) {
-    if (!repository_->saveToFile(filename)) {
-      lastError_ = "Cannot create file!";
+  OperationResult exportArchive(const std::string &filename) {
+    if (!archive::writeFile(directory_path, filename, *repository_)) {
+      lastError_ = "Cannot create archive!";
       return OperationResult::FILE_ERROR;
     }
     return OperationResult::SUCCESS;
   }
-  OperationResult loadFromFile(const std::string &filename) {
-    if (!repository_->loadFromFile(filename)) {
-      lastError_ = "File not exist!";
+  /**
+   * @brief Appends the archived rows matching @p query to the repository
+   *
+   * Rows matching a stored expense are handled per @p duplicates, through
+   * the same csv::RowLoader as CSV loads; FLAG inserts them and only counts
+   * them.
+   */
+  OperationResult importArchive(
+      const std::string &filename, const archive::Query &query = {},
+      repositories::csv::DuplicatePolicy duplicates =
+          repositories::csv::DuplicatePolicy::KEEP) {
+    repositories::csv::LoadOptions options;
+    options.append = true;
+    options.duplicates = duplicates;
+    options.maxDiagnostics = 0;
+    options = withBudgetHook(std::move(options));
+    repositories::csv::LoadResult applied;
+    repositories::csv::RowLoader loader{
+        applied, options,
+        [this](models::Expense &&e) { repository_->addExpense(e); },
+        repository_->rowHooks()};
+    lastAlerts_.clear();
+    size_t row = 0;
+    auto stats = archive::readFile(
+        directory_path, filename, query, [&](models::Expense &&e) {
+          loader.insert(std::move(e), ++row, 0);
+        });
+    if (!stats) {
+      lastError_ = "Cannot read archive!";
       return OperationResult::FILE_ERROR;
     }
+    lastArchiveStats_ = *stats;
+    lastArchiveStats_.duplicates = applied.duplicates;
     return OperationResult::SUCCESS;
   }
+  const stats::ExpenseSketches &getStatistics() const {
+    return repository_->getSketches();
+  }
+  const archive::ReadStats &getLastArchiveStats() const {
+    return lastArchiveStats_;
+  }
+  /**
+   * @brief Sets the monthly limit of @p category and saves the definitions
+   * to data_store/budgets.csv
+   *
+   * Counting the category's existing expenses is the only full pass;
+   * afterwards each add, edit, delete or appended row updates its month in
+   * O(1), and only a load replacing every row recounts.
+   */
+  OperationResult setBudget(const std::string &category, double limit,
+                            int warnPercent = 80) {
+    if (category.empty() || limit <= 0 || warnPercent <= 0 ||
+        warnPercent > 100) {
+      lastError_ = "Budget needs a category, a positive limit and a warning "
+                   "share between 1 and 100%";
+      return OperationResult::VALIDATION_ERROR;
+    }
+    budgets_.setBudget({category, limit, warnPercent}, *repository_);
+    return saveBudgets();
+  }
+  OperationResult removeBudget(const std::string &category) {
+    if (!budgets_.removeBudget(category)) {
+      lastError_ = "No budget for '" + category + "'";
+      return OperationResult::VALIDATION_ERROR;
+    }
+    return saveBudgets();
+  }
+  const std::map<std::string, budget::Budget> &getBudgets() const {
+    return budgets_.budgets();
+  }
+  /// Spent on a budgeted @p category in the month of @p date.
+  double getBudgetSpend(const std::string &category,
+                        const std::string &date) const {
+    return budgets_.spent(category, date);
+  }
+  /// Budget thresholds reached by the last add, edit, delete or import.
+  const std::vector<budget::Alert> &getLastAlerts() const {
+    return lastAlerts_;
+  }
   const std::string &getLastError() const { return lastError_; }
 
 private:
+  static constexpr const char *kBudgetFile = "budgets.csv";
+
   std::unique_ptr<repositories::ExpenseRepository> repository_;
   validator::ExpenseValidator validator_;
   std::string lastError_;
+  archive::ReadStats lastArchiveStats_;
+  repositories::csv::LoadResult lastLoadResult_;
+  importer::ImportStats lastImportStats_;
+  budget::BudgetTracker budgets_;
+  std::vector<budget::Alert> lastAlerts_;
+  const fs::path directory_path = "./data_store";
+
+  // A non-append load replaced every row; recount in one streaming scan
+  void rebuildBudgets() {
+    if (!budgets_.empty()) {
+      budgets_.rebuild(*repository_, &lastAlerts_);
+    }
+  }
+
+  // Appending loads keep the budget counters current row by row
+  repositories::csv::LoadOptions
+  withBudgetHook(repositories::csv::LoadOptions options) {
+    if (options.append && !budgets_.empty()) {
+      options.onRowApplied = [this, next = std::move(options.onRowApplied)](
+                                 const models::Expense *before,
+                                 const models::Expense *after) {
+        budgets_.apply(before, after, lastAlerts_);
+        if (next) {
+          next(before, after);
+        }
+      };
+    }
+    return options;
+  }
+
+  OperationResult saveBudgets() {
+    std::error_code ec;
+    fs::create_directories(directory_path, ec);
+    if (!budgets_.saveToFile(directory_path / kBudgetFile)) {
+      lastError_ = "Cannot save budgets!";
+      return OperationResult::FILE_ERROR;
+    }
+    return OperationResult::SUCCESS;
+  }
+
+  static constexpr size_t kFollowBatch = 4096;
 };
 
 } // namespace services
@@ -502,6 +3271,76 @@ private:
   ExpenseTrackerUI *ui_;
 };
 
+class ExportArchiveCommand : public Command {
+public:
+  explicit ExportArchiveCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Export Archive"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class ImportArchiveCommand : public Command {
+public:
+  explicit ImportArchiveCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Import Archive"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class StatisticsCommand : public Command {
+public:
+  explicit StatisticsCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Statistics"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class FollowFileCommand : public Command {
+public:
+  explicit FollowFileCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Follow File"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class BudgetsCommand : public Command {
+public:
+  explicit BudgetsCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Budgets"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class ViewDateRangeCommand : public Command {
+public:
+  explicit ViewDateRangeCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "View Date Range"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
+class ImportCsvCommand : public Command {
+public:
+  explicit ImportCsvCommand(ExpenseTrackerUI *ui) : ui_(ui) {}
+  void execute() override;
+  std::string getDescription() const override { return "Import Large CSV"; }
+
+private:
+  ExpenseTrackerUI *ui_;
+};
+
 class ExpenseTrackerUI {
 public:
   explicit ExpenseTrackerUI(std::unique_ptr<services::ExpenseService> service)
@@ -544,15 +3383,14 @@ public:
     auto result = service_->addExpense(title, amount, category, date);
     if (result == services::ExpenseService::OperationResult::SUCCESS) {
       std::cout << "✓ Expense added successfully!\n";
+      printBudgetAlerts();
     } else {
       std::cout << "✗ Error: " << service_->getLastError() << "\n";
     }
   }
 
   void viewExpensesInteractive() const {
-    const auto &expenses = service_->getAllExpenses();
-
-    if (expenses.empty()) {
+    if (service_->getExpenseCount() == 0) {
       std::cout << "No expenses found.\n";
       return;
     }
@@ -564,13 +3402,40 @@ public:
     std::cout
         << "╚═══════════════════════════════════════════════════════════╝\n";
 
-    for (size_t i = 0; i < expenses.size(); ++i) {
-      const auto &expense = expenses[i];
-      std::cout << std::setw(3) << "[" << i << "] " << std::left
+    size_t i = 0;
+    service_->forEachExpense([&i](const models::Expense &expense) {
+      std::cout << std::setw(3) << "[" << i++ << "] " << std::left
                 << std::setw(25) << expense.getTitle() << " $" << std::right
                 << std::setw(10) << std::fixed << std::setprecision(2)
                 << expense.getAmount() << "  " << std::setw(15)
                 << expense.getCategory() << "  " << expense.getDate() << "\n";
+      return true;
+    });
+    std::cout << std::string(60, '-') << "\n";
+  }
+
+  void viewDateRangeInteractive() const {
+    std::string from, to;
+    std::cout << "From date (YYYY-MM-DD): ";
+    std::getline(std::cin, from);
+    std::cout << "To date (YYYY-MM-DD): ";
+    std::getline(std::cin, to);
+    auto results = service_->getExpensesByDateRange(from, to);
+    if (!results) {
+      std::cout << "✗ Error: Dates must be YYYY-MM-DD\n";
+      return;
+    }
+    if (results->empty()) {
+      std::cout << "No expenses found from " << from << " to " << to << ".\n";
+      return;
+    }
+
+    for (const auto &expense : *results) {
+      std::cout << std::left << std::setw(25) << expense.getTitle() << " $"
+                << std::right << std::setw(10) << std::fixed
+                << std::setprecision(2) << expense.getAmount() << "  "
+                << std::setw(15) << expense.getCategory() << "  "
+                << expense.getDate() << "\n";
     }
     std::cout << std::string(60, '-') << "\n";
   }
@@ -578,7 +3443,7 @@ public:
   void editExpenseInteractive() {
     viewExpensesInteractive();
 
-    if (service_->getAllExpenses().empty()) {
+    if (service_->getExpenseCount() == 0) {
       return;
     }
 
@@ -606,6 +3471,7 @@ public:
     auto result = service_->updateExpense(index, title, amount, category, date);
     if (result == services::ExpenseService::OperationResult::SUCCESS) {
       std::cout << "✓ Expense updated successfully!\n";
+      printBudgetAlerts();
     } else {
       std::cout << "✗ Error: " << service_->getLastError() << "\n";
     }
@@ -614,7 +3480,7 @@ public:
   void deleteExpenseInteractive() {
     viewExpensesInteractive();
 
-    if (service_->getAllExpenses().empty()) {
+    if (service_->getExpenseCount() == 0) {
       return;
     }
 
@@ -632,6 +3498,7 @@ public:
       auto result = service_->deleteExpense(index);
       if (result == services::ExpenseService::OperationResult::SUCCESS) {
         std::cout << "✓ Expense deleted successfully!\n";
+        printBudgetAlerts();
       } else {
         std::cout << "✗ Error: " << service_->getLastError() << "\n";
       }
@@ -644,8 +3511,12 @@ public:
     std::cout << "Enter search query: ";
     std::string query;
     std::getline(std::cin, query);
+    std::cout << "Allowed typos (0 for exact match): ";
+    std::string typos;
+    std::getline(std::cin, typos);
+    size_t maxDistance = std::strtoul(typos.c_str(), nullptr, 10);
 
-    auto results = service_->searchExpenses(query);
+    auto results = service_->searchExpenses(query, maxDistance);
 
     if (results.empty()) {
       std::cout << "No expenses found matching '" << query << "'.\n";
@@ -672,6 +3543,7 @@ public:
     std::cout << "Calculate total for:\n";
     std::cout << "1. All expenses\n";
     std::cout << "2. Specific category\n";
+    std::cout << "3. Date range\n";
     std::cout << "Choice: ";
 
     int choice;
@@ -679,7 +3551,24 @@ public:
     std::cin.ignore();
 
     double total;
-    if (choice == 2) {
+    if (choice == 3) {
+      std::string from, to, category;
+      std::cout << "From date (YYYY-MM-DD): ";
+      std::getline(std::cin, from);
+      std::cout << "To date (YYYY-MM-DD): ";
+      std::getline(std::cin, to);
+      std::cout << "Category (empty for all): ";
+      std::getline(std::cin, category);
+      auto rangeTotal = service_->calculateRangeTotal(from, to, category);
+      if (!rangeTotal) {
+        std::cout << "✗ Error: Dates must be YYYY-MM-DD\n";
+        return;
+      }
+      std::cout << "Total from " << from << " to " << to
+                << (category.empty() ? "" : " for '" + category + "'")
+                << ": $" << std::fixed << std::setprecision(2) << *rangeTotal
+                << "\n";
+    } else if (choice == 2) {
       std::cout << "Enter category: ";
       std::string category;
       std::getline(std::cin, category);
@@ -725,18 +3614,383 @@ public:
       filename += ".csv";
     }
 
-    auto result = service_->loadFromFile(filename);
+    std::cout << "Skip rows that fail to parse? (y/n): ";
+    std::string skip;
+    std::getline(std::cin, skip);
+    std::cout << "Append to current expenses? (y/n): ";
+    std::string append;
+    std::getline(std::cin, append);
+
+    repositories::csv::LoadOptions options;
+    if (skip == "y" || skip == "Y") {
+      options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+    }
+    options.append = append == "y" || append == "Y";
+    options.duplicates = askDuplicatePolicy();
+    options.progressInterval = 10000;
+    options.onProgress = [](size_t rows) {
+      std::cout << "\rLoaded " << rows << " rows..." << std::flush;
+    };
+
+    loadAndReport(filename, options);
+  }
+
+  /**
+   * @brief Loads @p filename before the menu starts (or instead of it in
+   * batch mode) and reports rows, problems and budget alerts
+   *
+   * With @p append the stored expenses are kept and only the lines added
+   * to the file since the last run are read (see
+   * ExpenseService::resumeFile()), so a persistent store can load the same
+   * file on every start.
+   */
+  bool loadOnStartup(const std::string &filename, bool append = false) {
+    repositories::csv::LoadOptions options;
+    options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+    if (!append) {
+      return loadAndReport(filename, options);
+    }
+    options.append = true;
+    return report(filename, options,
+                  service_->resumeFile(filename, options));
+  }
+
+  void followFileInteractive() {
+    std::cout << "Enter filename to follow (without path): ";
+    std::string filename;
+    std::getline(std::cin, filename);
+    if (filename.empty()) {
+      filename = "expenses.csv";
+    }
+    // Add .csv extension if not present
+    if (filename.find(".csv") == std::string::npos) {
+      filename += ".csv";
+    }
+
+    std::cout << "Skip rows that fail to parse? (y/n): ";
+    std::string skip;
+    std::getline(std::cin, skip);
+    repositories::csv::LoadOptions options;
+    if (skip == "y" || skip == "Y") {
+      options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+    }
+    options.append = true;
+    options.duplicates = askDuplicatePolicy();
+
+    std::cout << "Following " << filename << ", press Enter to stop.\n";
+    size_t total = 0;
+    auto result = service_->followFile(
+        filename, options,
+        [this, &total](const repositories::csv::LoadResult &batch) {
+          if (batch.rowsLoaded) {
+            total += batch.rowsLoaded;
+            std::cout << "\r" << total << " rows appended" << std::flush;
+          }
+          if (!service_->getLastAlerts().empty()) {
+            std::cout << "\n";
+            printBudgetAlerts();
+          }
+          pollfd input{STDIN_FILENO, POLLIN, 0};
+          return ::poll(&input, 1, 0) <= 0;
+        });
+    if (total) {
+      std::cout << "\n";
+    }
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    const auto &load = service_->getLastLoadResult();
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cout << "✓ Stopped following " << filename << " ("
+                << load.rowsLoaded << " rows";
+      if (load.rowsSkipped) {
+        std::cout << ", " << load.rowsSkipped << " skipped";
+      }
+      if (load.duplicates) {
+        std::cout << ", " << load.duplicates << " duplicates";
+      }
+      std::cout << ")\n";
+    } else {
+      std::cout << "✗ Error: " << service_->getLastError() << "\n";
+    }
+  }
+
+  void importCsvInteractive() {
+    std::cout << "Enter filename to import (without path): ";
+    std::string filename;
+    std::getline(std::cin, filename);
+    if (filename.empty()) {
+      filename = "expenses.csv";
+    }
+
+    std::cout << "Skip rows that fail to parse or validate? (y/n): ";
+    std::string skip;
+    std::getline(std::cin, skip);
+    std::cout << "Append to current expenses? (y/n): ";
+    std::string append;
+    std::getline(std::cin, append);
+    std::cout << "Parser threads (empty for automatic): ";
+    std::string threads;
+    std::getline(std::cin, threads);
+
+    repositories::csv::LoadOptions options;
+    if (skip == "y" || skip == "Y") {
+      options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+    }
+    options.append = append == "y" || append == "Y";
+    options.duplicates = askDuplicatePolicy();
+    importer::Options tuning;
+    tuning.parserThreads = std::strtoul(threads.c_str(), nullptr, 10);
+
+    auto result = service_->importFile(filename, options, tuning);
+    const auto &load = service_->getLastLoadResult();
+    const auto &stats = service_->getLastImportStats();
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cout << "✓ Imported " << load.rowsLoaded << " rows from "
+                << filename << " in " << std::fixed << std::setprecision(2)
+                << stats.seconds << "s (" << load.rowsSkipped << " skipped, "
+                << load.duplicates << " duplicates)\n";
+    } else {
+      std::cout << "✗ Error: " << service_->getLastError() << "\n";
+    }
+    if (!stats.stages.empty()) {
+      std::cout << std::left << std::setw(10) << "Stage" << std::right
+                << std::setw(8) << "Threads" << std::setw(14) << "Items"
+                << std::setw(14) << "Items/s" << std::setw(12) << "Blocked"
+                << std::setw(12) << "Starved" << "\n";
+      for (const auto &stage : stats.stages) {
+        double rate = stage.busySeconds > 0 ? stage.items / stage.busySeconds
+                                            : 0.0;
+        std::cout << std::left << std::setw(10) << stage.name << std::right
+                  << std::setw(8) << stage.threads << std::setw(14)
+                  << stage.items << std::setw(14) << std::setprecision(0)
+                  << rate << std::setw(12) << stage.outputFullWaits
+                  << std::setw(12) << stage.inputEmptyWaits << "\n";
+      }
+    }
+    const size_t shown = std::min<size_t>(load.diagnostics.size(), 5);
+    for (size_t i = 0; i < shown; ++i) {
+      const auto &d = load.diagnostics[i];
+      std::cout << "  line " << d.lineNumber << " (byte " << d.byteOffset
+                << "): " << d.reason << "\n";
+    }
+    printBudgetAlerts();
+  }
+
+  void budgetsInteractive() {
+    const std::string today = dates::formatIsoDate(dates::fromEpochSeconds(
+        std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count()));
+    const auto &budgets = service_->getBudgets();
+    if (budgets.empty()) {
+      std::cout << "No budgets set.\n";
+    } else {
+      std::cout << std::left << std::setw(20) << "Category" << std::right
+                << std::setw(12) << "Limit" << std::setw(12)
+                << today.substr(0, 7) << std::setw(8) << "Used"
+                << std::setw(8) << "Warn" << "\n";
+      for (const auto &[category, budget] : budgets) {
+        double spent = service_->getBudgetSpend(category, today);
+        std::cout << std::left << std::setw(20) << category << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(12)
+                  << budget.limit << std::setw(12) << spent
+                  << std::setprecision(0) << std::setw(7)
+                  << spent * 100 / budget.limit << "%" << std::setw(7)
+                  << budget.warnPercent << "%\n";
+      }
+    }
+
+    std::cout << "(s)et a budget, (r)emove one, or Enter to go back: ";
+    std::string action;
+    std::getline(std::cin, action);
+    if (action.empty()) {
+      return;
+    }
+    std::cout << "Category: ";
+    std::string category;
+    std::getline(std::cin, category);
+
+    services::ExpenseService::OperationResult result;
+    if (std::tolower(action[0]) == 's') {
+      std::cout << "Monthly limit: ";
+      std::string limit;
+      std::getline(std::cin, limit);
+      std::cout << "Warn at percent of limit (default 80): ";
+      std::string warn;
+      std::getline(std::cin, warn);
+      result =
+          service_->setBudget(category, std::strtod(limit.c_str(), nullptr),
+                              warn.empty() ? 80 : std::atoi(warn.c_str()));
+    } else if (std::tolower(action[0]) == 'r') {
+      result = service_->removeBudget(category);
+    } else {
+      std::cout << "Invalid choice! Please try again.\n";
+      return;
+    }
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cout << "✓ Budgets saved\n";
+    } else {
+      std::cout << "✗ Error: " << service_->getLastError() << "\n";
+    }
+  }
+
+  void exportArchiveInteractive() const {
+    std::cout << "Enter archive filename (without path): ";
+    std::string filename;
+    std::getline(std::cin, filename);
+    if (filename.empty()) {
+      filename = "expenses.arc";
+    }
+
+    auto result = service_->exportArchive(filename);
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cout << "✓ Archive exported to: " << filename << "\n";
+    } else {
+      std::cout << "✗ Error: " << service_->getLastError() << "\n";
+    }
+  }
+
+  void importArchiveInteractive() {
+    std::cout << "Enter archive filename (without path): ";
+    std::string filename;
+    std::getline(std::cin, filename);
+    if (filename.empty()) {
+      filename = "expenses.arc";
+    }
+
+    archive::Query query;
+    std::cout << "From date (YYYY-MM-DD, empty for any): ";
+    std::getline(std::cin, query.from);
+    std::cout << "To date (YYYY-MM-DD, empty for any): ";
+    std::getline(std::cin, query.to);
+    std::cout << "Category (empty for any): ";
+    std::getline(std::cin, query.category);
+    auto duplicates = askDuplicatePolicy();
+
+    auto result = service_->importArchive(filename, query, duplicates);
     if (result == services::ExpenseService::OperationResult::SUCCESS) {
-      std::cout << "✓ Expenses loaded successfully from: " << filename << "\n";
+      const auto &stats = service_->getLastArchiveStats();
+      std::cout << "✓ Imported " << stats.rows << " expenses ("
+                << stats.blocksRead << " blocks read, " << stats.blocksSkipped
+                << " skipped, " << stats.duplicates << " duplicates)\n";
+      printBudgetAlerts();
     } else {
       std::cout << "✗ Error: " << service_->getLastError() << "\n";
     }
   }
 
+  void statisticsInteractive() const {
+    const auto &stats = service_->getStatistics();
+    if (stats.rows() == 0) {
+      std::cout << "No expenses found.\n";
+      return;
+    }
+
+    std::cout
+        << "\n╔═══════════════════════════════════════════════════════════╗\n";
+    std::cout
+        << "║                 Statistics (approximate)                  ║\n";
+    std::cout
+        << "╚═══════════════════════════════════════════════════════════╝\n";
+
+    std::cout << std::left << std::setw(20) << "Category" << std::right
+              << std::setw(10) << "Count" << std::setw(12) << "Median"
+              << std::setw(12) << "P95" << "\n";
+    auto printRow = [](const std::string &name,
+                       const sketches::KllSketch &amounts) {
+      std::cout << std::left << std::setw(20) << name << std::right
+                << std::setw(10) << amounts.count() << std::fixed
+                << std::setprecision(2) << std::setw(12)
+                << amounts.quantile(0.5) << std::setw(12)
+                << amounts.quantile(0.95) << "\n";
+    };
+    for (const auto &[category, amounts] : stats.byCategory()) {
+      printRow(category, amounts);
+    }
+    printRow("(all)", stats.amounts());
+    std::cout << std::string(60, '-') << "\n";
+
+    std::cout << "Distinct titles: ~" << std::setprecision(0)
+              << stats.distinctTitles() << "\n";
+    std::cout << "Most frequent titles:\n";
+    for (const auto &entry : stats.topTitles(5)) {
+      std::cout << "  " << std::left << std::setw(25) << entry.item
+                << std::right << " ~" << entry.count << "\n";
+    }
+  }
+
 private:
   std::unique_ptr<services::ExpenseService> service_;
   std::map<int, std::unique_ptr<Command>> commands_;
 
+  bool loadAndReport(const std::string &filename,
+                     const repositories::csv::LoadOptions &options) {
+    return report(filename, options, service_->loadFromFile(filename, options));
+  }
+
+  bool report(const std::string &filename,
+              const repositories::csv::LoadOptions &options,
+              services::ExpenseService::OperationResult result) {
+    const auto &load = service_->getLastLoadResult();
+    if (options.progressInterval &&
+        load.rowsLoaded >= options.progressInterval) {
+      std::cout << "\n";
+    }
+    if (result == services::ExpenseService::OperationResult::SUCCESS) {
+      std::cout << "✓ Expenses loaded successfully from: " << filename << " ("
+                << load.rowsLoaded << " rows";
+      if (load.rowsSkipped) {
+        std::cout << ", " << load.rowsSkipped << " skipped";
+      }
+      if (load.duplicates) {
+        std::cout << ", " << load.duplicates << " duplicates";
+      }
+      std::cout << ")\n";
+    } else {
+      std::cout << "✗ Error: " << service_->getLastError() << "\n";
+    }
+    const size_t shown = std::min<size_t>(load.diagnostics.size(), 5);
+    for (size_t i = 0; i < shown; ++i) {
+      const auto &d = load.diagnostics[i];
+      std::cout << "  line " << d.lineNumber << " (byte " << d.byteOffset
+                << "): " << d.reason << "\n";
+    }
+    if (load.diagnostics.size() > shown) {
+      std::cout << "  ... " << load.diagnostics.size() - shown << " more\n";
+    }
+    printBudgetAlerts();
+    return result == services::ExpenseService::OperationResult::SUCCESS;
+  }
+
+  void printBudgetAlerts() const {
+    for (const auto &alert : service_->getLastAlerts()) {
+      std::cout << (alert.exceeded ? "✗ Over budget: '"
+                                   : "⚠ Budget warning: '")
+                << alert.category << "' " << alert.month << " spent $"
+                << std::fixed << std::setprecision(2) << alert.spent
+                << " of $" << alert.limit << " ("
+                << std::setprecision(0) << alert.spent * 100 / alert.limit
+                << "%)\n";
+    }
+  }
+
+  static repositories::csv::DuplicatePolicy askDuplicatePolicy() {
+    std::cout << "Duplicates: (k)eep, (s)kip, (f)lag or (m)erge? ";
+    std::string answer;
+    std::getline(std::cin, answer);
+    switch (answer.empty() ? 'k' : std::tolower(answer[0])) {
+    case 's':
+      return repositories::csv::DuplicatePolicy::SKIP;
+    case 'f':
+      return repositories::csv::DuplicatePolicy::FLAG;
+    case 'm':
+      return repositories::csv::DuplicatePolicy::MERGE;
+    default:
+      return repositories::csv::DuplicatePolicy::KEEP;
+    }
+  }
+
   void setupCommands() {
     commands_[1] = std::make_unique<AddExpenseCommand>(this);
     commands_[2] = std::make_unique<ViewExpensesCommand>(this);
@@ -746,6 +4000,13 @@ private:
     commands_[6] = std::make_unique<CalculateTotalCommand>(this);
     commands_[7] = std::make_unique<SaveToFileCommand>(this);
     commands_[8] = std::make_unique<LoadFromFileCommand>(this);
+    commands_[9] = std::make_unique<ExportArchiveCommand>(this);
+    commands_[10] = std::make_unique<ImportArchiveCommand>(this);
+    commands_[11] = std::make_unique<StatisticsCommand>(this);
+    commands_[12] = std::make_unique<FollowFileCommand>(this);
+    commands_[13] = std::make_unique<BudgetsCommand>(this);
+    commands_[14] = std::make_unique<ImportCsvCommand>(this);
+    commands_[15] = std::make_unique<ViewDateRangeCommand>(this);
   }
 
   void displayMenu() const {
@@ -806,6 +4067,20 @@ inline void CalculateTotalCommand::execute() {
 inline void SaveToFileCommand::execute() { ui_->saveToFileInteractive(); }
 
 inline void LoadFromFileCommand::execute() { ui_->loadFromFileInteractive(); }
+
+inline void ExportArchiveCommand::execute() { ui_->exportArchiveInteractive(); }
+
+inline void ImportArchiveCommand::execute() { ui_->importArchiveInteractive(); }
+
+inline void StatisticsCommand::execute() { ui_->statisticsInteractive(); }
+
+inline void FollowFileCommand::execute() { ui_->followFileInteractive(); }
+
+inline void BudgetsCommand::execute() { ui_->budgetsInteractive(); }
+
+inline void ImportCsvCommand::execute() { ui_->importCsvInteractive(); }
+
+inline void ViewDateRangeCommand::execute() { ui_->viewDateRangeInteractive(); }
 } // namespace ui
 namespace factory {
 /**
@@ -820,6 +4095,15 @@ public:
         std::make_unique<services::ExpenseService>(std::move(repository));
     return std::make_unique<ui::ExpenseTrackerUI>(std::move(service));
   }
+  static std::unique_ptr<ui::ExpenseTrackerUI>
+  createDiskBackedApplication(const std::string &filename, size_t cachePages) {
+    auto repository =
+        std::make_unique<repositories::BPlusTreeExpenseRepository>(filename,
+                                                                   cachePages);
+    auto service =
+        std::make_unique<services::ExpenseService>(std::move(repository));
+    return std::make_unique<ui::ExpenseTrackerUI>(std::move(service));
+  }
 };
 
 } // namespace factory
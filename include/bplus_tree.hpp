@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace expense_tracker {
+namespace storage {
+namespace fs = std::filesystem;
+
+using PageId = std::uint32_t;
+
+/**
+ * @brief Fixed-size page file with a bounded LRU page cache
+ *
+ * Page 0 holds the file header: geometry, the page count and a small array
+ * of metadata slots that the trees and repositories built on top use for
+ * their roots and counters. Page 0 is never handed out, so it doubles as
+ * the null page id.
+ */
+class Pager {
+public:
+  static constexpr PageId kNullPage = 0;
+  static constexpr size_t kMetaSlots = 16;
+
+  Pager(const fs::path &path, size_t pageSize, size_t cachePages)
+      : path_{path}, pageSize_{pageSize},
+        cachePages_{std::max<size_t>(cachePages, 4)} {
+    if (pageSize_ < 512) {
+      throw std::invalid_argument("Page size must be at least 512 bytes");
+    }
+    if (!fs::exists(path_) || fs::file_size(path_) == 0) {
+      std::ofstream create(path_, std::ios::binary | std::ios::trunc);
+      if (!create) {
+        throw std::runtime_error("Cannot create page file: " + path_.string());
+      }
+    }
+    file_.open(path_, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file_) {
+      throw std::runtime_error("Cannot open page file: " + path_.string());
+    }
+    if (fs::file_size(path_) == 0) {
+      reset();
+    } else {
+      readHeader();
+    }
+  }
+  Pager(const Pager &) = delete;
+  Pager &operator=(const Pager &) = delete;
+  ~Pager() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  size_t pageSize() const noexcept { return pageSize_; }
+  std::uint64_t meta(size_t slot) const { return meta_.at(slot); }
+  void setMeta(size_t slot, std::uint64_t value) {
+    meta_.at(slot) = value;
+    headerDirty_ = true;
+  }
+
+  /// Copies page @p id into @p out (resized to the page size).
+  void read(PageId id, std::vector<char> &out) {
+    out = fetch(id).data;
+  }
+  /// Replaces the content of page @p id; written back on eviction or flush.
+  void write(PageId id, const std::vector<char> &data) {
+    auto &entry = fetch(id);
+    std::copy(data.begin(),
+              data.begin() + std::min(data.size(), entry.data.size()),
+              entry.data.begin());
+    entry.dirty = true;
+  }
+
+  PageId allocate() {
+    PageId id = pageCount_++;
+    headerDirty_ = true;
+    auto &entry = fetch(id, false);
+    entry.dirty = true;
+    return id;
+  }
+
+  /// Drops every page and reinitialises an empty file.
+  void reset() {
+    cache_.clear();
+    lru_.clear();
+    file_.close();
+    fs::resize_file(path_, 0);
+    file_.open(path_, std::ios::binary | std::ios::in | std::ios::out);
+    pageCount_ = 1;
+    meta_.fill(0);
+    headerDirty_ = true;
+    flush();
+  }
+
+  void flush() {
+    for (auto &[id, entry] : cache_) {
+      if (entry.dirty) {
+        writeBack(id, entry);
+      }
+    }
+    if (headerDirty_) {
+      writeHeader();
+    }
+    file_.flush();
+  }
+
+private:
+  struct CacheEntry {
+    std::vector<char> data;
+    bool dirty = false;
+    std::list<PageId>::iterator lruPos;
+  };
+  static constexpr std::uint64_t kMagic = 0x3145455254504245ULL; // "EBPTREE1"
+
+  fs::path path_;
+  std::fstream file_;
+  size_t pageSize_;
+  size_t cachePages_;
+  PageId pageCount_ = 1;
+  std::array<std::uint64_t, kMetaSlots> meta_{};
+  bool headerDirty_ = false;
+  std::unordered_map<PageId, CacheEntry> cache_;
+  std::list<PageId> lru_;
+
+  CacheEntry &fetch(PageId id, bool loadFromDisk = true) {
+    if (id == kNullPage || id >= pageCount_) {
+      throw std::out_of_range("Invalid page id " + std::to_string(id));
+    }
+    auto it = cache_.find(id);
+    if (it != cache_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lruPos);
+      return it->second;
+    }
+    while (cache_.size() >= cachePages_) {
+      PageId victim = lru_.back();
+      auto &evicted = cache_.at(victim);
+      if (evicted.dirty) {
+        writeBack(victim, evicted);
+      }
+      cache_.erase(victim);
+      lru_.pop_back();
+    }
+    CacheEntry entry;
+    entry.data.assign(pageSize_, 0);
+    if (loadFromDisk) {
+      file_.clear();
+      file_.seekg(static_cast<std::streamoff>(id) * pageSize_);
+      file_.read(entry.data.data(), static_cast<std::streamsize>(pageSize_));
+      file_.clear(); // pages past EOF read back as zeros
+    }
+    lru_.push_front(id);
+    entry.lruPos = lru_.begin();
+    return cache_.emplace(id, std::move(entry)).first->second;
+  }
+
+  void writeBack(PageId id, CacheEntry &entry) {
+    file_.clear();
+    file_.seekp(static_cast<std::streamoff>(id) * pageSize_);
+    file_.write(entry.data.data(), static_cast<std::streamsize>(pageSize_));
+    if (!file_) {
+      throw std::runtime_error("Failed to write page " + std::to_string(id));
+    }
+    entry.dirty = false;
+  }
+
+  void writeHeader() {
+    std::vector<char> header(pageSize_, 0);
+    char *p = header.data();
+    const std::uint32_t pageSize = static_cast<std::uint32_t>(pageSize_);
+    std::memcpy(p, &kMagic, 8);
+    std::memcpy(p + 8, &pageSize, 4);
+    std::memcpy(p + 12, &pageCount_, 4);
+    std::memcpy(p + 24, meta_.data(), sizeof(meta_));
+    file_.clear();
+    file_.seekp(0);
+    file_.write(header.data(), static_cast<std::streamsize>(pageSize_));
+    headerDirty_ = false;
+  }
+
+  void readHeader() {
+    char header[24 + sizeof(meta_)] = {};
+    file_.seekg(0);
+    file_.read(header, sizeof(header));
+    std::uint64_t magic = 0;
+    std::uint32_t pageSize = 0;
+    std::memcpy(&magic, header, 8);
+    std::memcpy(&pageSize, header + 8, 4);
+    if (!file_ || magic != kMagic) {
+      throw std::runtime_error("Not a B+tree page file: " + path_.string());
+    }
+    pageSize_ = pageSize;
+    std::memcpy(&pageCount_, header + 12, 4);
+    std::memcpy(meta_.data(), header + 24, sizeof(meta_));
+  }
+};
+
+/**
+ * @brief Page-based B+tree mapping a fixed-size key to a byte string
+ *
+ * Internal nodes keep the entry count of every child, so the tree also
+ * answers "k-th smallest key" in O(log n). Deletion removes entries without
+ * merging siblings: the height stays bounded by the peak size of the tree
+ * and emptied pages are reclaimed by clear().
+ */
+template <typename Key> class BPlusTree {
+  static_assert(std::is_trivially_copyable<Key>::value,
+                "B+tree keys are stored by memcpy");
+
+public:
+  using Visitor = std::function<bool(const Key &, const std::string &)>;
+
+  BPlusTree(Pager &pager, size_t rootSlot, size_t sizeSlot)
+      : pager_{pager}, rootSlot_{rootSlot}, sizeSlot_{sizeSlot} {
+    if (root() == Pager::kNullPage) {
+      clear();
+    }
+  }
+
+  /// Largest value accepted, chosen so that a split always yields two pages.
+  size_t maxValueSize() const {
+    return (pager_.pageSize() - kLeafHeader) / 4 - sizeof(Key) - 2;
+  }
+  std::uint64_t size() const { return pager_.meta(sizeSlot_); }
+
+  /// Inserts or replaces; returns true when the key was new.
+  bool insert(const Key &key, const std::string &value) {
+    if (value.size() > maxValueSize()) {
+      throw std::length_error("Record exceeds B+tree page capacity");
+    }
+    std::int64_t delta = 0;
+    auto split = insertInto(root(), key, value, delta);
+    if (split) {
+      Node newRoot;
+      newRoot.leaf = false;
+      newRoot.children = {root(), split->right};
+      newRoot.counts = {split->leftCount, split->rightCount};
+      newRoot.keys = {split->separator};
+      PageId id = pager_.allocate();
+      store(id, newRoot);
+      pager_.setMeta(rootSlot_, id);
+    }
+    pager_.setMeta(sizeSlot_, size() + delta);
+    return delta == 1;
+  }
+
+  bool erase(const Key &key) {
+    bool erased = eraseFrom(root(), key);
+    if (erased) {
+      pager_.setMeta(sizeSlot_, size() - 1);
+    }
+    return erased;
+  }
+
+  std::optional<std::string> find(const Key &key) const {
+    Node node = load(root());
+    while (!node.leaf) {
+      node = load(node.children[childFor(node, key)]);
+    }
+    auto it = std::lower_bound(node.keys.begin(), node.keys.end(), key);
+    if (it == node.keys.end() || key < *it) {
+      return std::nullopt;
+    }
+    return node.values[it - node.keys.begin()];
+  }
+
+  /// k-th smallest entry (0-based) using the per-child counts.
+  std::optional<std::pair<Key, std::string>> nth(std::uint64_t rank) const {
+    if (rank >= size()) {
+      return std::nullopt;
+    }
+    Node node = load(root());
+    while (!node.leaf) {
+      size_t i = 0;
+      while (i + 1 < node.children.size() && rank >= node.counts[i]) {
+        rank -= node.counts[i++];
+      }
+      node = load(node.children[i]);
+    }
+    return std::make_pair(node.keys[rank], node.values[rank]);
+  }
+
+  /// Visits entries in key order starting at @p from (or the first key)
+  /// until the visitor returns false.
+  void scan(const Visitor &visit, const Key *from = nullptr) const {
+    Node node = load(root());
+    while (!node.leaf) {
+      node = load(node.children[from ? childFor(node, *from) : 0]);
+    }
+    size_t i = from ? std::lower_bound(node.keys.begin(), node.keys.end(),
+                                       *from) -
+                          node.keys.begin()
+                    : 0;
+    while (true) {
+      for (; i < node.keys.size(); ++i) {
+        if (!visit(node.keys[i], node.values[i])) {
+          return;
+        }
+      }
+      if (node.next == Pager::kNullPage) {
+        return;
+      }
+      node = load(node.next);
+      i = 0;
+    }
+  }
+
+  /// Starts a fresh empty tree; callers owning the pager reset it first.
+  void clear() {
+    Node leaf;
+    PageId id = pager_.allocate();
+    store(id, leaf);
+    pager_.setMeta(rootSlot_, id);
+    pager_.setMeta(sizeSlot_, 0);
+  }
+
+private:
+  static constexpr size_t kLeafHeader = 1 + 2 + 4;
+  static constexpr size_t kInternalHeader = 1 + 2;
+  static constexpr size_t kChildEntry = 4 + 8;
+
+  struct Node {
+    bool leaf = true;
+    PageId next = Pager::kNullPage;
+    std::vector<Key> keys;
+    std::vector<std::string> values;     // leaf only
+    std::vector<PageId> children;        // internal only
+    std::vector<std::uint64_t> counts;   // internal only
+  };
+  struct Split {
+    Key separator;
+    PageId right;
+    std::uint64_t leftCount;
+    std::uint64_t rightCount;
+  };
+
+  Pager &pager_;
+  size_t rootSlot_;
+  size_t sizeSlot_;
+
+  PageId root() const { return static_cast<PageId>(pager_.meta(rootSlot_)); }
+
+  static size_t childFor(const Node &node, const Key &key) {
+    return std::upper_bound(node.keys.begin(), node.keys.end(), key) -
+           node.keys.begin();
+  }
+
+  static size_t encodedSize(const Node &node) {
+    if (!node.leaf) {
+      return kInternalHeader + node.children.size() * kChildEntry +
+             node.keys.size() * sizeof(Key);
+    }
+    size_t bytes = kLeafHeader;
+    for (const auto &v : node.values) {
+      bytes += sizeof(Key) + 2 + v.size();
+    }
+    return bytes;
+  }
+
+  Node load(PageId id) const {
+    std::vector<char> page;
+    pager_.read(id, page);
+    const char *p = page.data();
+    Node node;
+    node.leaf = p[0] != 2;
+    std::uint16_t count = 0;
+    std::memcpy(&count, p + 1, 2);
+    if (node.leaf) {
+      std::memcpy(&node.next, p + 3, 4);
+      p += kLeafHeader;
+      node.keys.resize(count);
+      node.values.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        std::uint16_t len = 0;
+        std::memcpy(&node.keys[i], p, sizeof(Key));
+        std::memcpy(&len, p + sizeof(Key), 2);
+        p += sizeof(Key) + 2;
+        node.values[i].assign(p, len);
+        p += len;
+      }
+    } else {
+      p += kInternalHeader;
+      node.children.resize(count);
+      node.counts.resize(count);
+      for (size_t i = 0; i < count; ++i, p += kChildEntry) {
+        std::memcpy(&node.children[i], p, 4);
+        std::memcpy(&node.counts[i], p + 4, 8);
+      }
+      node.keys.resize(count ? count - 1 : 0);
+      for (auto &k : node.keys) {
+        std::memcpy(&k, p, sizeof(Key));
+        p += sizeof(Key);
+      }
+    }
+    return node;
+  }
+
+  void store(PageId id, const Node &node) {
+    std::vector<char> page(pager_.pageSize(), 0);
+    char *p = page.data();
+    p[0] = node.leaf ? 1 : 2;
+    if (node.leaf) {
+      std::uint16_t count = static_cast<std::uint16_t>(node.keys.size());
+      std::memcpy(p + 1, &count, 2);
+      std::memcpy(p + 3, &node.next, 4);
+      p += kLeafHeader;
+      for (size_t i = 0; i < node.keys.size(); ++i) {
+        std::uint16_t len = static_cast<std::uint16_t>(node.values[i].size());
+        std::memcpy(p, &node.keys[i], sizeof(Key));
+        std::memcpy(p + sizeof(Key), &len, 2);
+        p += sizeof(Key) + 2;
+        std::memcpy(p, node.values[i].data(), len);
+        p += len;
+      }
+    } else {
+      std::uint16_t count = static_cast<std::uint16_t>(node.children.size());
+      std::memcpy(p + 1, &count, 2);
+      p += kInternalHeader;
+      for (size_t i = 0; i < node.children.size(); ++i, p += kChildEntry) {
+        std::memcpy(p, &node.children[i], 4);
+        std::memcpy(p + 4, &node.counts[i], 8);
+      }
+      for (const auto &k : node.keys) {
+        std::memcpy(p, &k, sizeof(Key));
+        p += sizeof(Key);
+      }
+    }
+    pager_.write(id, page);
+  }
+
+  static std::uint64_t total(const Node &node) {
+    if (node.leaf) {
+      return node.keys.size();
+    }
+    std::uint64_t sum = 0;
+    for (auto c : node.counts) {
+      sum += c;
+    }
+    return sum;
+  }
+
+  std::optional<Split> splitIfFull(PageId id, Node &node) {
+    if (encodedSize(node) <= pager_.pageSize()) {
+      store(id, node);
+      return std::nullopt;
+    }
+    Node right;
+    right.leaf = node.leaf;
+    Key separator;
+    if (node.leaf) {
+      // split on bytes so variable-length records balance both halves
+      size_t half = encodedSize(node) / 2, bytes = kLeafHeader, cut = 0;
+      while (cut + 1 < node.keys.size() && bytes < half) {
+        bytes += sizeof(Key) + 2 + node.values[cut++].size();
+      }
+      cut = std::max<size_t>(cut, 1);
+      right.keys.assign(node.keys.begin() + cut, node.keys.end());
+      right.values.assign(node.values.begin() + cut, node.values.end());
+      node.keys.resize(cut);
+      node.values.resize(cut);
+      separator = right.keys.front();
+      right.next = node.next;
+    } else {
+      size_t cut = node.children.size() / 2;
+      separator = node.keys[cut - 1];
+      right.children.assign(node.children.begin() + cut, node.children.end());
+      right.counts.assign(node.counts.begin() + cut, node.counts.end());
+      right.keys.assign(node.keys.begin() + cut, node.keys.end());
+      node.children.resize(cut);
+      node.counts.resize(cut);
+      node.keys.resize(cut - 1);
+    }
+    PageId rightId = pager_.allocate();
+    if (node.leaf) {
+      node.next = rightId;
+    }
+    store(rightId, right);
+    store(id, node);
+    return Split{separator, rightId, total(node), total(right)};
+  }
+
+  std::optional<Split> insertInto(PageId id, const Key &key,
+                                  const std::string &value,
+                                  std::int64_t &delta) {
+    Node node = load(id);
+    if (node.leaf) {
+      auto it = std::lower_bound(node.keys.begin(), node.keys.end(), key);
+      size_t pos = it - node.keys.begin();
+      if (it != node.keys.end() && !(key < *it)) {
+        node.values[pos] = value;
+      } else {
+        node.keys.insert(it, key);
+        node.values.insert(node.values.begin() + pos, value);
+        delta = 1;
+      }
+      return splitIfFull(id, node);
+    }
+    size_t i = childFor(node, key);
+    auto split = insertInto(node.children[i], key, value, delta);
+    if (!split) {
+      if (delta == 0) {
+        return std::nullopt; // counts unchanged, page untouched
+      }
+      node.counts[i] += delta;
+    } else {
+      node.counts[i] = split->leftCount;
+      node.children.insert(node.children.begin() + i + 1, split->right);
+      node.counts.insert(node.counts.begin() + i + 1, split->rightCount);
+      node.keys.insert(node.keys.begin() + i, split->separator);
+    }
+    return splitIfFull(id, node);
+  }
+
+  bool eraseFrom(PageId id, const Key &key) {
+    Node node = load(id);
+    if (node.leaf) {
+      auto it = std::lower_bound(node.keys.begin(), node.keys.end(), key);
+      if (it == node.keys.end() || key < *it) {
+        return false;
+      }
+      node.values.erase(node.values.begin() + (it - node.keys.begin()));
+      node.keys.erase(it);
+      store(id, node);
+      return true;
+    }
+    size_t i = childFor(node, key);
+    if (!eraseFrom(node.children[i], key)) {
+      return false;
+    }
+    --node.counts[i];
+    store(id, node);
+    return true;
+  }
+};
+} // namespace storage
+} // namespace expense_tracker
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace expense_tracker {
+namespace codec {
+/**
+ * @brief Appends @p value as an LEB128 varint
+ */
+inline void putVarint(std::string &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline std::uint64_t zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * @brief Bounds-checked cursor over an encoded buffer
+ */
+class Reader {
+public:
+  Reader(const char *data, size_t size) : p_{data}, end_{data + size} {}
+
+  bool atEnd() const noexcept { return p_ == end_; }
+  size_t remaining() const noexcept { return static_cast<size_t>(end_ - p_); }
+
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (p_ == end_) {
+        throw std::runtime_error("Truncated varint");
+      }
+      auto byte = static_cast<unsigned char>(*p_++);
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    throw std::runtime_error("Malformed varint");
+  }
+  std::int64_t svarint() { return unzigzag(varint()); }
+
+  const char *take(size_t n) {
+    if (remaining() < n) {
+      throw std::runtime_error("Truncated buffer");
+    }
+    const char *start = p_;
+    p_ += n;
+    return start;
+  }
+  template <typename T> T fixed() {
+    T value;
+    std::memcpy(&value, take(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string bytes() {
+    size_t n = static_cast<size_t>(varint());
+    return std::string(take(n), n);
+  }
+
+private:
+  const char *p_;
+  const char *end_;
+};
+
+namespace detail {
+inline void putLength(std::string &out, size_t length) {
+  while (length >= 255) {
+    out.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+inline size_t getLength(Reader &in, size_t length) {
+  if (length == 15) {
+    unsigned char byte;
+    do {
+      byte = static_cast<unsigned char>(*in.take(1));
+      length += byte;
+    } while (byte == 255);
+  }
+  return length;
+}
+} // namespace detail
+
+/**
+ * @brief Byte-oriented LZ77 compressor (LZ4-style token stream)
+ *
+ * Each sequence is a token (literal length, match length - 4), the literals
+ * and a 16-bit back-reference. Tuned for short repetitive strings such as
+ * expense titles rather than for ratio.
+ */
+inline std::string compress(const std::string &input) {
+  constexpr size_t kMinMatch = 4;
+  constexpr size_t kHashBits = 12;
+  std::string out;
+  out.reserve(input.size() / 2 + 16);
+  std::vector<std::int64_t> table(size_t{1} << kHashBits, -1);
+  const char *in = input.data();
+  const size_t n = input.size();
+  size_t anchor = 0, i = 0;
+
+  auto emit = [&](size_t literalEnd, size_t offset, size_t matchLength) {
+    size_t literals = literalEnd - anchor;
+    size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+    out.push_back(static_cast<char>((std::min<size_t>(literals, 15) << 4) |
+                                    std::min<size_t>(matchCode, 15)));
+    if (literals >= 15) {
+      detail::putLength(out, literals - 15);
+    }
+    out.append(in + anchor, literals);
+    if (matchLength) {
+      out.push_back(static_cast<char>(offset & 0xFF));
+      out.push_back(static_cast<char>(offset >> 8));
+      if (matchCode >= 15) {
+        detail::putLength(out, matchCode - 15);
+      }
+    }
+  };
+
+  while (i + kMinMatch <= n) {
+    std::uint32_t sequence;
+    std::memcpy(&sequence, in + i, sizeof(sequence));
+    size_t slot = (sequence * 2654435761u) >> (32 - kHashBits);
+    std::int64_t candidate = table[slot];
+    table[slot] = static_cast<std::int64_t>(i);
+    if (candidate >= 0 && i - candidate <= 0xFFFF &&
+        std::memcmp(in + candidate, in + i, kMinMatch) == 0) {
+      size_t length = kMinMatch;
+      while (i + length < n && in[candidate + length] == in[i + length]) {
+        ++length;
+      }
+      emit(i, i - static_cast<size_t>(candidate), length);
+      i += length;
+      anchor = i;
+    } else {
+      ++i;
+    }
+  }
+  emit(n, 0, 0);
+  return out;
+}
+
+/**
+ * @brief Inverse of compress(); @p size is the original length
+ */
+inline std::string decompress(const char *data, size_t length, size_t size) {
+  std::string out;
+  out.reserve(size);
+  Reader in{data, length};
+  while (!in.atEnd()) {
+    auto token = static_cast<unsigned char>(*in.take(1));
+    size_t literals = detail::getLength(in, token >> 4);
+    out.append(in.take(literals), literals);
+    if (in.atEnd()) {
+      break;
+    }
+    size_t offset = static_cast<unsigned char>(*in.take(1));
+    offset |= static_cast<size_t>(static_cast<unsigned char>(*in.take(1))) << 8;
+    size_t matchLength = detail::getLength(in, token & 0x0F) + 4;
+    if (offset == 0 || offset > out.size()) {
+      throw std::runtime_error("Corrupt compressed block");
+    }
+    size_t from = out.size() - offset;
+    for (size_t k = 0; k < matchLength; ++k) {
+      out.push_back(out[from + k]);
+    }
+  }
+  if (out.size() != size) {
+    throw std::runtime_error("Compressed block size mismatch");
+  }
+  return out;
+}
+} // namespace codec
+} // namespace expense_tracker
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+
+namespace expense_tracker {
+namespace dates {
+/**
+ * @brief Calendar fields of an expense date
+ */
+struct CivilTime {
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+};
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date
+ */
+inline std::int64_t daysFromCivil(int year, int month, int day) {
+  year -= month <= 2;
+  const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const int yoe = static_cast<int>(year - era * 400);
+  const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Inverse of daysFromCivil()
+ */
+inline void civilFromDays(std::int64_t days, int &year, int &month, int &day) {
+  days += 719468;
+  const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const int doe = static_cast<int>(days - era * 146097);
+  const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+/**
+ * @brief Seconds since 1970-01-01 00:00:00, ignoring time zones
+ */
+inline std::int64_t toEpochSeconds(const CivilTime &t) {
+  return daysFromCivil(t.year, t.month, t.day) * 86400 + t.hour * 3600 +
+         t.minute * 60 + t.second;
+}
+
+/**
+ * @brief Inverse of toEpochSeconds()
+ */
+inline CivilTime fromEpochSeconds(std::int64_t seconds) {
+  CivilTime t;
+  std::int64_t days =
+      seconds >= 0 ? seconds / 86400 : (seconds - 86399) / 86400;
+  int secondOfDay = static_cast<int>(seconds - days * 86400);
+  civilFromDays(days, t.year, t.month, t.day);
+  t.hour = secondOfDay / 3600;
+  t.minute = secondOfDay / 60 % 60;
+  t.second = secondOfDay % 60;
+  return t;
+}
+
+namespace detail {
+// Writes @p value right-aligned in @p width chars, padded with @p pad
+inline void putDigits(char *out, int value, int width, char pad = '0') {
+  for (int i = width - 1; i >= 0; --i) {
+    out[i] = (value > 0 || i == width - 1) ? static_cast<char>('0' + value % 10)
+                                           : pad;
+    value /= 10;
+  }
+}
+} // namespace detail
+
+/// "YYYY-MM-DD"
+inline std::string formatIsoDate(const CivilTime &t) {
+  std::string out = "0000-00-00";
+  detail::putDigits(&out[0], t.year, 4);
+  detail::putDigits(&out[5], t.month, 2);
+  detail::putDigits(&out[8], t.day, 2);
+  return out;
+}
+
+/// "YYYY-MM-DD HH:MM:SS"
+inline std::string formatIsoDateTime(const CivilTime &t) {
+  std::string out = formatIsoDate(t) + " 00:00:00";
+  detail::putDigits(&out[11], t.hour, 2);
+  detail::putDigits(&out[14], t.minute, 2);
+  detail::putDigits(&out[17], t.second, 2);
+  return out;
+}
+
+/// ctime() layout without the trailing newline, e.g. "Fri Oct  3 01:52:09 2025"
+inline std::string formatCtime(const CivilTime &t) {
+  static const char *weekdays[] = {"Thu", "Fri", "Sat", "Sun",
+                                   "Mon", "Tue", "Wed"};
+  static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  std::int64_t days = daysFromCivil(t.year, t.month, t.day);
+  int weekday = static_cast<int>(((days % 7) + 7) % 7); // 1970-01-01 = Thu
+  std::string out = "Www Mmm dd 00:00:00 ";
+  out.replace(0, 3, weekdays[weekday]);
+  out.replace(4, 3, months[(t.month - 1) % 12]);
+  detail::putDigits(&out[8], t.day, 2, ' ');
+  detail::putDigits(&out[11], t.hour, 2);
+  detail::putDigits(&out[14], t.minute, 2);
+  detail::putDigits(&out[17], t.second, 2);
+  out += std::to_string(t.year);
+  return out;
+}
+
+/**
+ * @brief Parses the date layouts the tracker writes
+ *
+ * Accepts "YYYY-MM-DD", "YYYY-MM-DD HH:MM:SS" and the ctime() layout
+ * "Www Mmm dd hh:mm:ss yyyy" used when no date is entered.
+ */
+inline std::optional<CivilTime> parse(const std::string &text) {
+  CivilTime t;
+  int consumed = 0;
+  if (std::sscanf(text.c_str(), "%4d-%2d-%2d%n", &t.year, &t.month, &t.day,
+                  &consumed) == 3) {
+    if (static_cast<size_t>(consumed) != text.size() &&
+        (std::sscanf(text.c_str() + consumed, " %2d:%2d:%2d%n", &t.hour,
+                     &t.minute, &t.second, &consumed) != 3)) {
+      return std::nullopt;
+    }
+  } else {
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    char weekday[4] = {}, month[4] = {};
+    if (std::sscanf(text.c_str(), "%3s %3s %d %d:%d:%d %d", weekday, month,
+                    &t.day, &t.hour, &t.minute, &t.second, &t.year) != 7) {
+      return std::nullopt;
+    }
+    for (int m = 0; m < 12; ++m) {
+      if (std::string(month) == months[m]) {
+        t.month = m + 1;
+      }
+    }
+  }
+  if (t.month < 1 || t.month > 12 || t.day < 1 || t.day > 31 || t.hour < 0 ||
+      t.hour > 23 || t.minute < 0 || t.minute > 59 || t.second < 0 ||
+      t.second > 60) {
+    return std::nullopt;
+  }
+  return t;
+}
+
+/**
+ * @brief Orderable YYYYMMDDhhmmss key, 0 for dates that cannot be parsed
+ */
+inline std::int64_t sortKey(const std::string &text) {
+  auto t = parse(text);
+  if (!t) {
+    return 0;
+  }
+  return ((((t->year * 100LL + t->month) * 100 + t->day) * 100 + t->hour) *
+              100 +
+          t->minute) *
+             100 +
+         t->second;
+}
+
+/**
+ * @brief Day number (days since 1970-01-01) of a date string
+ */
+inline std::optional<std::int64_t> dayNumber(const std::string &text) {
+  auto t = parse(text);
+  if (!t) {
+    return std::nullopt;
+  }
+  return daysFromCivil(t->year, t->month, t->day);
+}
+} // namespace dates
+} // namespace expense_tracker
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace expense_tracker {
+namespace rollups {
+/**
+ * @brief Fenwick (binary indexed) tree over positions [0, size)
+ *
+ * Point updates and prefix sums are O(log n).
+ */
+template <typename T> class FenwickTree {
+public:
+  explicit FenwickTree(size_t size = 0) : tree_(size, T{}) {}
+
+  size_t size() const noexcept { return tree_.size(); }
+
+  void add(size_t index, T delta) {
+    for (++index; index <= tree_.size(); index += index & (~index + 1)) {
+      tree_[index - 1] += delta;
+    }
+  }
+
+  /// Sum of positions [0, end).
+  T prefix(size_t end) const {
+    T sum{};
+    for (end = std::min(end, tree_.size()); end > 0; end -= end & (~end + 1)) {
+      sum += tree_[end - 1];
+    }
+    return sum;
+  }
+
+  /// Sum of positions [first, last], empty when first > last.
+  T range(size_t first, size_t last) const {
+    return first > last ? T{} : prefix(last + 1) - prefix(first);
+  }
+
+private:
+  std::vector<T> tree_;
+};
+} // namespace rollups
+} // namespace expense_tracker
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace expense_tracker {
+namespace tail {
+/**
+ * @brief How far a followed file has been consumed
+ *
+ * @p offset is the byte just after the last complete line handed out;
+ * @p inode identifies the file it refers to, so a file replaced while
+ * nobody was following starts over from its first byte.
+ */
+struct Position {
+  std::uint64_t offset = 0;
+  std::uint64_t inode = 0;
+  size_t lines = 0;
+
+  bool operator==(const Position &other) const {
+    return offset == other.offset && inode == other.inode &&
+           lines == other.lines;
+  }
+};
+
+/**
+ * @brief Inode of @p path, 0 if it cannot be examined
+ */
+inline std::uint64_t inodeOf(const std::filesystem::path &path) {
+  struct stat info {};
+  return ::stat(path.c_str(), &info) == 0
+             ? static_cast<std::uint64_t>(info.st_ino)
+             : 0;
+}
+
+/**
+ * @brief Complete line read from a followed file
+ */
+struct Line {
+  std::string text; // without the newline
+  std::uint64_t offset = 0;
+  size_t number = 0; // 1-based, counted from the start of the file
+};
+
+/**
+ * @brief Hands out lines appended to a file, a batch at a time
+ *
+ * Only complete lines are returned; a trailing line still being written is
+ * left unconsumed and read again once its newline arrives. A file that
+ * shrinks below the consumed offset was truncated and is read from the
+ * start. A file replaced under the same name (log rotation) has the rest
+ * of the old file drained first, then the new one is read from the start.
+ *
+ * On Linux wait() sleeps on an inotify watch of the parent directory, which
+ * also reports the file being created or renamed into place; elsewhere it
+ * simply sleeps for the timeout.
+ */
+class FileFollower {
+public:
+  explicit FileFollower(std::filesystem::path path, Position from = {})
+      : path_{std::move(path)}, position_{from} {
+#ifdef __linux__
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd_ >= 0) {
+      auto directory = path_.parent_path().empty() ? std::filesystem::path(".")
+                                                   : path_.parent_path();
+      if (inotify_add_watch(notifyFd_, directory.c_str(),
+                            IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE |
+                                IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+        ::close(notifyFd_);
+        notifyFd_ = -1;
+      }
+    }
+#endif
+    open();
+    if (fd_ >= 0 && position_.inode != 0 && position_.inode != inode_) {
+      ++rotations_; // replaced since the position was taken
+      position_ = {0, inode_, 0};
+    }
+    position_.inode = inode_;
+  }
+  ~FileFollower() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    if (notifyFd_ >= 0) {
+      ::close(notifyFd_);
+    }
+  }
+  FileFollower(const FileFollower &) = delete;
+  FileFollower &operator=(const FileFollower &) = delete;
+
+  const Position &position() const noexcept { return position_; }
+  bool isOpen() const noexcept { return fd_ >= 0; }
+  size_t truncations() const noexcept { return truncations_; }
+  size_t rotations() const noexcept { return rotations_; }
+
+  /**
+   * @brief Blocks until the file may have changed or @p timeoutMs elapses
+   *
+   * Returns true when a change was reported.
+   */
+  bool wait(int timeoutMs) {
+    if (notifyFd_ < 0) {
+      ::usleep(static_cast<useconds_t>(timeoutMs) * 1000);
+      return true;
+    }
+    pollfd waiter{notifyFd_, POLLIN, 0};
+    if (::poll(&waiter, 1, timeoutMs) <= 0) {
+      return false;
+    }
+    bool relevant = false;
+#ifdef __linux__
+    alignas(inotify_event) char events[4096];
+    ssize_t length;
+    while ((length = ::read(notifyFd_, events, sizeof(events))) > 0) {
+      for (ssize_t at = 0; at < length;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(events + at);
+        relevant |= event->len > 0 && path_.filename() == event->name;
+        at += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      }
+    }
+#endif
+    return relevant;
+  }
+
+  /**
+   * @brief Calls @p onLine for up to @p maxLines complete lines appended
+   * since the last call and returns how many there were
+   */
+  size_t readLines(const std::function<void(Line &&)> &onLine,
+                   size_t maxLines = SIZE_MAX) {
+    size_t count = 0;
+    struct stat current {};
+    const bool exists = ::stat(path_.c_str(), &current) == 0;
+    if (fd_ >= 0 && exists &&
+        static_cast<std::uint64_t>(current.st_ino) != inode_) {
+      count += drain(onLine, maxLines); // rotated: finish the old file first
+      if (count == maxLines) {
+        return count;
+      }
+      ::close(fd_);
+      fd_ = -1;
+      ++rotations_;
+      position_ = {};
+    }
+    if (fd_ < 0) {
+      if (!exists) {
+        return count;
+      }
+      open();
+      position_ = {0, inode_, 0};
+    }
+    struct stat opened {};
+    if (::fstat(fd_, &opened) == 0 &&
+        static_cast<std::uint64_t>(opened.st_size) < position_.offset) {
+      ++truncations_;
+      position_.offset = 0;
+      position_.lines = 0;
+    }
+    return count + drain(onLine, maxLines - count);
+  }
+
+private:
+  static constexpr size_t kChunk = 64 * 1024;
+
+  std::filesystem::path path_;
+  Position position_;
+  int fd_ = -1;
+  int notifyFd_ = -1;
+  std::uint64_t inode_ = 0;
+  size_t truncations_ = 0;
+  size_t rotations_ = 0;
+
+  void open() {
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info {};
+    if (fd_ >= 0 && ::fstat(fd_, &info) == 0) {
+      inode_ = static_cast<std::uint64_t>(info.st_ino);
+    }
+  }
+
+  size_t drain(const std::function<void(Line &&)> &onLine, size_t maxLines) {
+    size_t count = 0;
+    std::string pending;
+    std::uint64_t readAt = position_.offset;
+    char chunk[kChunk];
+    ssize_t got;
+    while (count < maxLines &&
+           ((got = ::pread(fd_, chunk, sizeof(chunk),
+                           static_cast<off_t>(readAt))) > 0 ||
+            (got < 0 && errno == EINTR))) {
+      if (got < 0) {
+        continue;
+      }
+      readAt += static_cast<std::uint64_t>(got);
+      pending.append(chunk, static_cast<size_t>(got));
+      size_t start = 0;
+      for (size_t end; count < maxLines &&
+                       (end = pending.find('\n', start)) != std::string::npos;
+           start = end + 1) {
+        Line line{pending.substr(start, end - start), position_.offset,
+                  ++position_.lines};
+        position_.offset += end - start + 1;
+        onLine(std::move(line));
+        ++count;
+      }
+      pending.erase(0, start);
+    }
+    return count;
+  }
+};
+} // namespace tail
+} // namespace expense_tracker
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace expense_tracker {
+namespace fuzzy {
+/**
+ * @brief Trimmed, lower-cased form under which text is compared
+ */
+inline std::string normalize(std::string text) {
+  text.erase(0, text.find_first_not_of(" \t"));
+  text.erase(text.find_last_not_of(" \t") + 1);
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return text;
+}
+
+/**
+ * @brief Levenshtein distance with @p pattern preprocessed once
+ *
+ * Patterns up to 64 bytes use Myers' bit-parallel kernel (one pass of a
+ * few word operations per text byte); longer ones fall back to the
+ * row-by-row dynamic programme.
+ */
+class EditDistance {
+public:
+  explicit EditDistance(std::string pattern) : pattern_{std::move(pattern)} {
+    if (pattern_.size() <= 64) {
+      for (size_t i = 0; i < pattern_.size(); ++i) {
+        peq_[static_cast<unsigned char>(pattern_[i])] |= std::uint64_t{1}
+                                                         << i;
+      }
+    }
+  }
+
+  size_t operator()(const std::string &text) const {
+    const size_t m = pattern_.size();
+    if (m == 0) {
+      return text.size();
+    }
+    if (m > 64) {
+      return dynamic(text);
+    }
+    const std::uint64_t high = std::uint64_t{1} << (m - 1);
+    std::uint64_t pv = ~std::uint64_t{0};
+    std::uint64_t mv = 0;
+    size_t score = m;
+    for (unsigned char c : text) {
+      const std::uint64_t eq = peq_[c];
+      const std::uint64_t xv = eq | mv;
+      const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+      std::uint64_t ph = mv | ~(xh | pv);
+      std::uint64_t mh = pv & xh;
+      if (ph & high) {
+        ++score;
+      } else if (mh & high) {
+        --score;
+      }
+      // the first row grows by one per text byte
+      ph = (ph << 1) | 1;
+      mh <<= 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+    }
+    return score;
+  }
+
+private:
+  std::string pattern_;
+  std::array<std::uint64_t, 256> peq_{};
+
+  size_t dynamic(const std::string &text) const {
+    std::vector<size_t> row(pattern_.size() + 1);
+    for (size_t i = 0; i < row.size(); ++i) {
+      row[i] = i;
+    }
+    for (size_t j = 1; j <= text.size(); ++j) {
+      size_t diagonal = row[0];
+      row[0] = j;
+      for (size_t i = 1; i < row.size(); ++i) {
+        size_t above = row[i];
+        row[i] = std::min({row[i] + 1, row[i - 1] + 1,
+                           diagonal + (pattern_[i - 1] != text[j - 1])});
+        diagonal = above;
+      }
+    }
+    return row.back();
+  }
+};
+
+/**
+ * @brief BK-tree over distinct strings, with reference counts
+ *
+ * Each child edge is labelled with its distance to the parent, so a search
+ * within k only descends into edges labelled d - k .. d + k (triangle
+ * inequality) and visits a small part of the dictionary. BK-trees cannot
+ * delete, so remove() only drops the count and search() skips terms whose
+ * count reached zero; adding them again revives the node.
+ */
+class BkTree {
+public:
+  struct Match {
+    std::string term;
+    size_t distance = 0;
+  };
+
+  size_t size() const noexcept { return live_; }
+
+  void add(const std::string &term) {
+    auto found = index_.find(term);
+    if (found != index_.end()) {
+      live_ += nodes_[found->second].count++ == 0;
+      return;
+    }
+    const size_t fresh = nodes_.size();
+    nodes_.push_back({term, 1, {}});
+    index_.emplace(term, fresh);
+    ++live_;
+    if (fresh == 0) {
+      return;
+    }
+    const EditDistance distanceTo{term};
+    size_t at = 0;
+    while (true) {
+      const size_t d = distanceTo(nodes_[at].term);
+      auto &children = nodes_[at].children;
+      auto child = std::find_if(children.begin(), children.end(),
+                                [d](const auto &c) { return c.first == d; });
+      if (child == children.end()) {
+        children.emplace_back(d, fresh);
+        return;
+      }
+      at = child->second;
+    }
+  }
+
+  void remove(const std::string &term) {
+    auto found = index_.find(term);
+    if (found != index_.end() && nodes_[found->second].count > 0) {
+      live_ -= --nodes_[found->second].count == 0;
+    }
+  }
+
+  void clear() {
+    nodes_.clear();
+    index_.clear();
+    live_ = 0;
+  }
+
+  /// Live terms within @p maxDistance of @p query, closest first.
+  std::vector<Match> search(const std::string &query,
+                            size_t maxDistance) const {
+    std::vector<Match> matches;
+    if (nodes_.empty()) {
+      return matches;
+    }
+    const EditDistance distanceTo{query};
+    std::vector<size_t> pending{0};
+    while (!pending.empty()) {
+      const Node &node = nodes_[pending.back()];
+      pending.pop_back();
+      const size_t d = distanceTo(node.term);
+      if (d <= maxDistance && node.count > 0) {
+        matches.push_back({node.term, d});
+      }
+      for (const auto &[edge, child] : node.children) {
+        if (edge + maxDistance >= d && edge <= d + maxDistance) {
+          pending.push_back(child);
+        }
+      }
+    }
+    std::sort(matches.begin(), matches.end(),
+              [](const Match &a, const Match &b) {
+                return a.distance != b.distance ? a.distance < b.distance
+                                                : a.term < b.term;
+              });
+    return matches;
+  }
+
+private:
+  struct Node {
+    std::string term;
+    size_t count = 0;
+    std::vector<std::pair<size_t, size_t>> children; // distance, node
+  };
+
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, size_t> index_;
+  size_t live_ = 0;
+};
+} // namespace fuzzy
+} // namespace expense_tracker
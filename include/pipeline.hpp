@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace expense_tracker {
+namespace pipeline {
+namespace detail {
+inline size_t roundUpToPowerOfTwo(size_t n) {
+  size_t size = 2;
+  while (size < n) {
+    size <<= 1;
+  }
+  return size;
+}
+
+// Spin briefly, then yield, then sleep: waits are expected to be short
+inline void backoff(unsigned &spins) {
+  if (++spins < 64) {
+    return;
+  }
+  if (spins < 128) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer
+ *
+ * A ring of slots indexed by ever-increasing head and tail counters; each
+ * side caches the other's counter and only rereads it when the ring looks
+ * full or empty.
+ */
+template <typename T> class SpscQueue {
+public:
+  explicit SpscQueue(size_t capacity)
+      : mask_{detail::roundUpToPowerOfTwo(capacity) - 1},
+        slots_{std::make_unique<T[]>(mask_ + 1)} {}
+
+  /// Moves @p item in unless the queue is full.
+  bool tryPush(T &item) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - headCache_ > mask_) {
+      headCache_ = head_.load(std::memory_order_acquire);
+      if (tail - headCache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::move(item);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T &item) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tailCache_) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head == tailCache_) {
+        return false;
+      }
+    }
+    item = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  const size_t mask_;
+  std::unique_ptr<T[]> slots_;
+  // consumer side
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tailCache_ = 0;
+  // producer side
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t headCache_ = 0;
+};
+
+/**
+ * @brief Bounded lock-free queue for any number of producers and consumers
+ *
+ * Dmitry Vyukov's design: every cell carries a sequence number telling
+ * whether it is ready to be written or read in the current lap, so
+ * producers and consumers only contend on their own position counter.
+ */
+template <typename T> class MpmcQueue {
+public:
+  explicit MpmcQueue(size_t capacity)
+      : mask_{detail::roundUpToPowerOfTwo(capacity) - 1},
+        cells_{std::make_unique<Cell[]>(mask_ + 1)} {
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Moves @p item in unless the queue is full.
+  bool tryPush(T &item) {
+    size_t pos = enqueue_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[pos & mask_];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence == pos) {
+        if (enqueue_.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+          cell.value = std::move(item);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos) {
+        return false; // the cell still holds last lap's item
+      } else {
+        pos = enqueue_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool tryPop(T &item) {
+    size_t pos = dequeue_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[pos & mask_];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence == pos + 1) {
+        if (dequeue_.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+          item = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos + 1) {
+        return false; // nothing written here yet
+      } else {
+        pos = dequeue_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<size_t> enqueue_{0};
+  alignas(64) std::atomic<size_t> dequeue_{0};
+};
+
+/**
+ * @brief Queue between two pipeline stages
+ *
+ * Adds blocking push/pop on top of the lock-free queue, end of stream once
+ * every producer called producerDone(), cancellation, and counters of how
+ * often each side had to wait: pushes on a full queue are backpressure from
+ * downstream, pops on an empty one are starvation from upstream.
+ */
+template <typename T, template <typename> class Queue> class Link {
+public:
+  Link(size_t capacity, size_t producers, const std::atomic<bool> &cancelled)
+      : queue_{capacity}, producers_{producers}, cancelled_{cancelled} {}
+
+  /// Blocks while the queue is full; false if the pipeline was cancelled.
+  bool push(T item) {
+    unsigned spins = 0;
+    while (!queue_.tryPush(item)) {
+      if (cancelled_.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      if (spins == 0) {
+        fullWaits_.fetch_add(1, std::memory_order_relaxed);
+      }
+      detail::backoff(spins);
+    }
+    return true;
+  }
+
+  /// Blocks while the queue is empty; false once it is drained and every
+  /// producer is done, or the pipeline was cancelled.
+  bool pop(T &item) {
+    unsigned spins = 0;
+    while (!queue_.tryPop(item)) {
+      if (cancelled_.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      if (producers_.load(std::memory_order_acquire) == 0) {
+        return queue_.tryPop(item);
+      }
+      if (spins == 0) {
+        emptyWaits_.fetch_add(1, std::memory_order_relaxed);
+      }
+      detail::backoff(spins);
+    }
+    return true;
+  }
+
+  void producerDone() { producers_.fetch_sub(1, std::memory_order_release); }
+
+  std::uint64_t fullWaits() const { return fullWaits_.load(); }
+  std::uint64_t emptyWaits() const { return emptyWaits_.load(); }
+
+private:
+  Queue<T> queue_;
+  std::atomic<size_t> producers_;
+  const std::atomic<bool> &cancelled_;
+  std::atomic<std::uint64_t> fullWaits_{0};
+  std::atomic<std::uint64_t> emptyWaits_{0};
+};
+} // namespace pipeline
+} // namespace expense_tracker
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "column_codec.hpp"
+
+namespace expense_tracker {
+namespace sketches {
+/**
+ * @brief Stable 64-bit string hash (FNV-1a with a splitmix64 finaliser)
+ *
+ * std::hash is not stable across builds, and sketches are persisted.
+ */
+inline std::uint64_t hash64(const std::string &text, std::uint64_t seed = 0) {
+  std::uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+  for (unsigned char c : text) {
+    h = (h ^ c) * 0x100000001b3ULL;
+  }
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+/**
+ * @brief KLL quantile sketch over doubles
+ *
+ * Level h holds items of weight 2^h; a full level is sorted and every other
+ * item promoted. Rank error is about 1.7 / k with O(k) memory.
+ */
+class KllSketch {
+public:
+  explicit KllSketch(std::uint32_t k = 200) : k_{k} {}
+
+  std::uint64_t count() const noexcept { return n_; }
+  double min() const noexcept { return min_; }
+  double max() const noexcept { return max_; }
+
+  void add(double value) {
+    if (n_++ == 0) {
+      min_ = max_ = value;
+    }
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (levels_.empty()) {
+      levels_.emplace_back();
+    }
+    levels_[0].push_back(value);
+    compress();
+  }
+
+  void merge(const KllSketch &other) {
+    if (other.n_ == 0) {
+      return;
+    }
+    if (n_ == 0) {
+      min_ = other.min_;
+      max_ = other.max_;
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    n_ += other.n_;
+    if (levels_.size() < other.levels_.size()) {
+      levels_.resize(other.levels_.size());
+    }
+    for (size_t h = 0; h < other.levels_.size(); ++h) {
+      levels_[h].insert(levels_[h].end(), other.levels_[h].begin(),
+                        other.levels_[h].end());
+    }
+    compress();
+  }
+
+  /// Approximate value at rank @p q in [0, 1].
+  double quantile(double q) const {
+    if (n_ == 0) {
+      return 0.0;
+    }
+    std::vector<std::pair<double, std::uint64_t>> weighted;
+    for (size_t h = 0; h < levels_.size(); ++h) {
+      for (double v : levels_[h]) {
+        weighted.emplace_back(v, std::uint64_t{1} << h);
+      }
+    }
+    std::sort(weighted.begin(), weighted.end());
+    std::uint64_t total = 0;
+    for (const auto &w : weighted) {
+      total += w.second;
+    }
+    const double target = std::clamp(q, 0.0, 1.0) * total;
+    std::uint64_t seen = 0;
+    for (const auto &[value, weight] : weighted) {
+      seen += weight;
+      if (seen >= target) {
+        return value;
+      }
+    }
+    return max_;
+  }
+
+  void serialize(std::string &out) const {
+    codec::putVarint(out, k_);
+    codec::putVarint(out, n_);
+    putDouble(out, min_);
+    putDouble(out, max_);
+    codec::putVarint(out, levels_.size());
+    for (const auto &level : levels_) {
+      codec::putVarint(out, level.size());
+      for (double v : level) {
+        putDouble(out, v);
+      }
+    }
+  }
+  static KllSketch deserialize(codec::Reader &in) {
+    KllSketch sketch{static_cast<std::uint32_t>(in.varint())};
+    sketch.n_ = in.varint();
+    sketch.min_ = in.fixed<double>();
+    sketch.max_ = in.fixed<double>();
+    sketch.levels_.resize(in.varint());
+    for (auto &level : sketch.levels_) {
+      level.resize(in.varint());
+      for (auto &v : level) {
+        v = in.fixed<double>();
+      }
+    }
+    return sketch;
+  }
+
+private:
+  std::uint32_t k_;
+  std::uint64_t n_ = 0;
+  double min_ = 0.0;
+  double max_ = 0.0;
+  std::vector<std::vector<double>> levels_;
+  std::uint64_t coin_ = 0x9e3779b97f4a7c15ULL;
+
+  static void putDouble(std::string &out, double v) {
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+  }
+
+  size_t capacity(size_t level) const {
+    const size_t depth = levels_.size() - 1 - level;
+    return std::max<size_t>(
+        2, static_cast<size_t>(k_ * std::pow(2.0 / 3.0, depth)) + 1);
+  }
+
+  void compress() {
+    for (size_t h = 0; h < levels_.size(); ++h) {
+      if (levels_[h].size() < capacity(h)) {
+        continue;
+      }
+      if (h + 1 == levels_.size()) {
+        levels_.emplace_back();
+      }
+      auto &level = levels_[h];
+      std::sort(level.begin(), level.end());
+      coin_ ^= coin_ << 13;
+      coin_ ^= coin_ >> 7;
+      coin_ ^= coin_ << 17;
+      // an odd item out stays behind so weights are preserved
+      size_t keep = level.size() % 2;
+      for (size_t i = keep + (coin_ & 1); i < level.size(); i += 2) {
+        levels_[h + 1].push_back(level[i]);
+      }
+      level.resize(keep);
+    }
+  }
+};
+
+/**
+ * @brief HyperLogLog distinct counter with 2^precision one-byte registers
+ */
+class HyperLogLog {
+public:
+  explicit HyperLogLog(std::uint8_t precision = 12)
+      : precision_{precision}, registers_(size_t{1} << precision, 0) {}
+
+  void add(const std::string &item) {
+    std::uint64_t h = hash64(item);
+    size_t index = h >> (64 - precision_);
+    std::uint64_t rest =
+        (h << precision_) | (std::uint64_t{1} << (precision_ - 1));
+    std::uint8_t rank = static_cast<std::uint8_t>(countLeadingZeros(rest) + 1);
+    registers_[index] = std::max(registers_[index], rank);
+  }
+
+  void merge(const HyperLogLog &other) {
+    if (other.precision_ != precision_) {
+      return;
+    }
+    for (size_t i = 0; i < registers_.size(); ++i) {
+      registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+  }
+
+  double estimate() const {
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (auto r : registers_) {
+      sum += std::ldexp(1.0, -r);
+      zeros += r == 0;
+    }
+    double raw = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+      return m * std::log(m / static_cast<double>(zeros)); // linear counting
+    }
+    return raw;
+  }
+
+  void serialize(std::string &out) const {
+    out.push_back(static_cast<char>(precision_));
+    out.append(registers_.begin(), registers_.end());
+  }
+  static HyperLogLog deserialize(codec::Reader &in) {
+    HyperLogLog hll{static_cast<std::uint8_t>(*in.take(1))};
+    const char *bytes = in.take(hll.registers_.size());
+    hll.registers_.assign(bytes, bytes + hll.registers_.size());
+    return hll;
+  }
+
+private:
+  std::uint8_t precision_;
+  std::vector<std::uint8_t> registers_;
+
+  static int countLeadingZeros(std::uint64_t x) {
+    int n = 0;
+    for (std::uint64_t bit = std::uint64_t{1} << 63; bit && !(x & bit);
+         bit >>= 1) {
+      ++n;
+    }
+    return n;
+  }
+};
+
+/**
+ * @brief Count-Min sketch: frequency upper bounds for any item
+ */
+class CountMinSketch {
+public:
+  CountMinSketch(std::uint32_t width = 2048, std::uint32_t depth = 4)
+      : width_{width}, depth_{depth}, cells_(size_t{width} * depth, 0) {}
+
+  void add(const std::string &item, std::uint64_t count = 1) {
+    for (std::uint32_t row = 0; row < depth_; ++row) {
+      cells_[cell(row, item)] += count;
+    }
+  }
+  std::uint64_t estimate(const std::string &item) const {
+    std::uint64_t best = UINT64_MAX;
+    for (std::uint32_t row = 0; row < depth_; ++row) {
+      best = std::min(best, cells_[cell(row, item)]);
+    }
+    return best;
+  }
+  void merge(const CountMinSketch &other) {
+    if (other.width_ == width_ && other.depth_ == depth_) {
+      for (size_t i = 0; i < cells_.size(); ++i) {
+        cells_[i] += other.cells_[i];
+      }
+    }
+  }
+
+  void serialize(std::string &out) const {
+    codec::putVarint(out, width_);
+    codec::putVarint(out, depth_);
+    for (auto c : cells_) {
+      codec::putVarint(out, c);
+    }
+  }
+  static CountMinSketch deserialize(codec::Reader &in) {
+    auto width = static_cast<std::uint32_t>(in.varint());
+    auto depth = static_cast<std::uint32_t>(in.varint());
+    CountMinSketch sketch{width, depth};
+    for (auto &c : sketch.cells_) {
+      c = in.varint();
+    }
+    return sketch;
+  }
+
+private:
+  std::uint32_t width_;
+  std::uint32_t depth_;
+  std::vector<std::uint64_t> cells_;
+
+  size_t cell(std::uint32_t row, const std::string &item) const {
+    return size_t{row} * width_ + hash64(item, row + 1) % width_;
+  }
+};
+
+/**
+ * @brief Space-Saving top-k heavy hitters
+ *
+ * Tracks at most @p capacity items; a new item evicts the current minimum
+ * and inherits its count as overestimation error.
+ */
+class SpaceSaving {
+public:
+  struct Entry {
+    std::string item;
+    std::uint64_t count = 0;
+    std::uint64_t error = 0;
+  };
+
+  explicit SpaceSaving(size_t capacity = 64) : capacity_{capacity} {}
+
+  void add(const std::string &item, std::uint64_t count = 1,
+           std::uint64_t error = 0) {
+    auto it = index_.find(item);
+    if (it != index_.end()) {
+      entries_[it->second].count += count;
+      entries_[it->second].error += error;
+      return;
+    }
+    if (entries_.size() < capacity_) {
+      index_.emplace(item, entries_.size());
+      entries_.push_back({item, count, error});
+      return;
+    }
+    auto victim = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const Entry &a, const Entry &b) { return a.count < b.count; });
+    index_.erase(victim->item);
+    index_.emplace(item, victim - entries_.begin());
+    *victim = {item, victim->count + count, victim->count + error};
+  }
+
+  void merge(const SpaceSaving &other) {
+    for (const auto &e : other.entries_) {
+      add(e.item, e.count, e.error);
+    }
+  }
+
+  /// The @p k most frequent items, highest count first.
+  std::vector<Entry> top(size_t k) const {
+    std::vector<Entry> sorted = entries_;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Entry &a, const Entry &b) { return a.count > b.count; });
+    if (sorted.size() > k) {
+      sorted.resize(k);
+    }
+    return sorted;
+  }
+
+  void serialize(std::string &out) const {
+    codec::putVarint(out, capacity_);
+    codec::putVarint(out, entries_.size());
+    for (const auto &e : entries_) {
+      codec::putVarint(out, e.item.size());
+      out += e.item;
+      codec::putVarint(out, e.count);
+      codec::putVarint(out, e.error);
+    }
+  }
+  static SpaceSaving deserialize(codec::Reader &in) {
+    SpaceSaving sketch{static_cast<size_t>(in.varint())};
+    for (size_t n = in.varint(); n > 0; --n) {
+      std::string item = in.bytes();
+      std::uint64_t count = in.varint();
+      std::uint64_t error = in.varint();
+      sketch.add(item, count, error);
+    }
+    return sketch;
+  }
+
+private:
+  size_t capacity_;
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, size_t> index_;
+};
+} // namespace sketches
+} // namespace expense_tracker
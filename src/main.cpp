@@ -18,6 +18,9 @@ int main(int argc, char *argv[])
     // Parse command line arguments (optional)
     std::string defaultFile = "expenses.csv";
     bool autoLoad = false;
+    bool batch = false;
+    std::string diskFile;
+    size_t cachePages = 256;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -30,6 +33,9 @@ int main(int argc, char *argv[])
         std::cout << "  -h, --help              Show this help message\n";
         std::cout << "  -f, --file <filename>   Specify default file to load\n";
         std::cout << "  -l, --load              Auto-load default file on startup\n";
+        std::cout << "  -b, --batch             Load default file, report budget alerts and exit\n";
+        std::cout << "  -d, --disk <filename>   Store expenses in an on-disk B+tree file\n";
+        std::cout << "  --cache-pages <n>       Pages kept in memory by the disk store\n";
         std::cout << "  -v, --version           Show version information\n";
         return 0;
       }
@@ -49,15 +55,43 @@ int main(int argc, char *argv[])
         autoLoad = true;
         std::cout << "Auto-load enabled\n";
       }
+      else if (arg == "--batch" || arg == "-b")
+      {
+        batch = true;
+      }
+      else if ((arg == "--disk" || arg == "-d") && i + 1 < argc)
+      {
+        diskFile = argv[++i];
+        std::cout << "Disk store set to: " << diskFile << "\n";
+      }
+      else if (arg == "--cache-pages" && i + 1 < argc)
+      {
+        cachePages = std::stoul(argv[++i]);
+      }
     }
 
     // Create the application using factory
-    auto app = expense_tracker::factory::ExpenseTrackerFactory::createApplication();
+    auto app = diskFile.empty()
+                   ? expense_tracker::factory::ExpenseTrackerFactory::createApplication()
+                   : expense_tracker::factory::ExpenseTrackerFactory::createDiskBackedApplication(
+                         diskFile, cachePages);
+
+    // A disk store already holds earlier rows: startup loads append only the
+    // lines added to the file since they were read, instead of replacing it
+    const bool appendToStore = !diskFile.empty();
+
+    // Batch mode: load, report and exit without the menu
+    if (batch)
+    {
+      std::cout << "\nLoading expenses from: " << defaultFile << "\n";
+      return app->loadOnStartup(defaultFile, appendToStore) ? 0 : 1;
+    }
 
     // Auto-load expenses if requested
     if (autoLoad)
     {
       std::cout << "\nAttempting to load expenses from: " << defaultFile << "\n";
+      app->loadOnStartup(defaultFile, appendToStore);
     }
 
     // Run the application
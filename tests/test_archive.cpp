@@ -0,0 +1,129 @@
+#include "test_support.hpp"
+
+#include <random>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+
+namespace {
+std::string randomText(std::mt19937 &rng, size_t maxLength,
+                       const char *alphabet) {
+  const size_t letters = std::strlen(alphabet);
+  std::string text(rng() % (maxLength + 1), ' ');
+  for (char &c : text) {
+    c = alphabet[rng() % letters];
+  }
+  return text;
+}
+
+void testCompression() {
+  std::mt19937 rng(11);
+  std::vector<std::string> inputs{"", "a", "abcd", std::string(1000, 'x'),
+                                  std::string(300, 'q') + "tail"};
+  for (int i = 0; i < 300; ++i) {
+    // short alphabets give long matches, wide ones long literal runs
+    inputs.push_back(randomText(rng, 2000, i % 2 ? "ab" : "abcdefghijklmnop"));
+  }
+  std::string large; // back-references cannot reach further than 64 KiB
+  while (large.size() < 200000) {
+    large += randomText(rng, 64, "abcdefghijklmnopqrstuvwxyz");
+  }
+  inputs.push_back(large);
+  for (const auto &input : inputs) {
+    std::string packed = codec::compress(input);
+    assert(codec::decompress(packed.data(), packed.size(), input.size()) ==
+           input);
+  }
+  std::string packed = codec::compress(std::string(100, 'z'));
+  bool threw = false;
+  try {
+    codec::decompress(packed.data(), packed.size(), 99);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+// Several blocks of January..December rows, plus dates that only survive raw
+repositories::InMemoryExpenseRepository sampleHistory() {
+  repositories::InMemoryExpenseRepository repository;
+  for (const char *date :
+       {"2025-02-30", "2025-02-28 23:59:60", "2025-13-01", "2024-02-29",
+        "Sat Feb 30 10:00:00 2025", "2025-01-01 00:00:00",
+        "Wed Jan  1 00:00:00 2025", "Thu Jan  1 00:00:00 2025", "0999-01-01",
+        "junk"}) {
+    repository.addExpense(models::Expense("edge", 1.5, "c", date));
+  }
+  std::mt19937 rng(17);
+  for (int month = 1; month <= 12; ++month) {
+    for (size_t i = 0; i < archive::detail::kBlockRows / 2; ++i) {
+      char date[16];
+      std::snprintf(date, sizeof(date), "2025-%02d-%02d", month,
+                    static_cast<int>(rng() % 28 + 1));
+      repository.addExpense(models::Expense(
+          "title " + std::to_string(rng() % 300), (rng() % 100000) / 100.0,
+          month == 12 ? "December only" : "c" + std::to_string(rng() % 9),
+          date));
+    }
+  }
+  repository.addExpense(models::Expense("precise", 0.125, "c", "2025-06-01"));
+  return repository;
+}
+
+std::vector<models::Expense> readBack(const std::string &filename,
+                                      const archive::Query &query,
+                                      archive::ReadStats *stats = nullptr) {
+  std::vector<models::Expense> rows;
+  auto result = archive::readFile(testing::kDataStore, filename, query,
+                                  [&rows](models::Expense &&expense) {
+                                    rows.push_back(std::move(expense));
+                                  });
+  assert(result);
+  if (stats) {
+    *stats = *result;
+  }
+  return rows;
+}
+
+void testRoundTrip() {
+  DataStoreFile file{"test_archive.arc"};
+  const auto history = sampleHistory();
+  assert(archive::writeFile(testing::kDataStore, file.name(), history));
+  assert(readBack(file.name(), {}) == history.getAllExpenses());
+  assert(fs::file_size(file.path()) < history.size() * 20);
+}
+
+void testQueriesSkipBlocks() {
+  DataStoreFile file{"test_archive.arc"};
+  const auto history = sampleHistory();
+  assert(archive::writeFile(testing::kDataStore, file.name(), history));
+
+  archive::Query march{"2025-03-01", "2025-03-31", ""};
+  archive::ReadStats stats;
+  auto rows = readBack(file.name(), march, &stats);
+  std::vector<models::Expense> expected;
+  history.forEach([&](const models::Expense &e) {
+    const auto key = dates::sortKey(e.getDate());
+    if (key >= dates::sortKey("2025-03-01") &&
+        key <= dates::sortKey("2025-03-31 23:59:59")) {
+      expected.push_back(e);
+    }
+    return true;
+  });
+  assert(rows == expected && !expected.empty());
+  assert(stats.blocksSkipped > 0 && stats.blocksRead < 4);
+
+  archive::Query december{"", "", "December only"};
+  rows = readBack(file.name(), december, &stats);
+  assert(rows.size() == archive::detail::kBlockRows / 2);
+  assert(stats.blocksSkipped > stats.blocksRead);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"lz codec", testCompression},
+      {"round trip", testRoundTrip},
+      {"queries skip blocks", testQueriesSkipBlocks},
+  });
+}
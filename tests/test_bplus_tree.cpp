@@ -0,0 +1,168 @@
+#include "test_support.hpp"
+
+#include <map>
+#include <random>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+using Result = services::ExpenseService::OperationResult;
+
+namespace {
+std::string randomTitle(std::mt19937 &rng) {
+  return std::string(rng() % 40 + 1, static_cast<char>('a' + rng() % 26));
+}
+
+models::Expense randomExpense(std::mt19937 &rng) {
+  char date[16];
+  std::snprintf(date, sizeof(date), "2025-%02d-%02d",
+                static_cast<int>(rng() % 12 + 1),
+                static_cast<int>(rng() % 28 + 1));
+  return models::Expense(randomTitle(rng), rng() % 1000 + 1,
+                         "c" + std::to_string(rng() % 5), date);
+}
+
+void testTreeMatchesMap() {
+  DataStoreFile file{"test_tree.bpt"};
+  std::map<std::uint64_t, std::string> reference;
+  std::mt19937 rng(7);
+  auto matches = [&reference](const storage::BPlusTree<std::uint64_t> &tree) {
+    assert(tree.size() == reference.size());
+    auto expected = reference.begin();
+    tree.scan([&](const std::uint64_t &key, const std::string &value) {
+      assert(expected != reference.end() && expected->first == key &&
+             expected->second == value);
+      ++expected;
+      return true;
+    });
+    assert(expected == reference.end());
+  };
+  {
+    storage::Pager pager{file.path(), 512, 8};
+    storage::BPlusTree<std::uint64_t> tree{pager, 0, 1};
+    for (int step = 0; step < 20000; ++step) {
+      const std::uint64_t key = rng() % 3000;
+      if (rng() % 4 == 0) {
+        assert(tree.erase(key) == (reference.erase(key) == 1));
+      } else {
+        std::string value = randomTitle(rng);
+        assert(tree.insert(key, value) ==
+               reference.insert_or_assign(key, value).second);
+      }
+      if (step % 500 == 0) {
+        const std::uint64_t probe = rng() % 3000;
+        auto found = reference.find(probe);
+        assert(tree.find(probe) ==
+               (found == reference.end()
+                    ? std::nullopt
+                    : std::optional<std::string>{found->second}));
+      }
+    }
+    matches(tree);
+    size_t rank = 0;
+    for (const auto &[key, value] : reference) {
+      if (rank % 97 == 0) {
+        auto entry = tree.nth(rank);
+        assert(entry && entry->first == key && entry->second == value);
+      }
+      ++rank;
+    }
+    assert(!tree.nth(reference.size()));
+    const std::uint64_t from = 1500;
+    auto expected = reference.lower_bound(from);
+    tree.scan(
+        [&expected](const std::uint64_t &key, const std::string &) {
+          assert(key == expected->first);
+          ++expected;
+          return key < 1600;
+        },
+        &from);
+  }
+  // reopened from disk
+  storage::Pager pager{file.path(), 512, 8};
+  storage::BPlusTree<std::uint64_t> tree{pager, 0, 1};
+  matches(tree);
+}
+
+void testRepositoryMatchesMemory() {
+  DataStoreFile file{"test_store.bpt"}, sketch{"test_store.bpt.sketch"};
+  std::mt19937 rng(1);
+  repositories::InMemoryExpenseRepository memory;
+  {
+    // a small cache and pages force evictions and deep trees
+    repositories::BPlusTreeExpenseRepository disk{file.name(), 8, 512};
+    for (int step = 0; step < 5000; ++step) {
+      const auto e = randomExpense(rng);
+      const unsigned op = rng() % 10;
+      if (op < 6 || memory.size() == 0) {
+        memory.addExpense(e);
+        disk.addExpense(e);
+      } else if (op < 8) {
+        const size_t i = rng() % memory.size();
+        memory.updateExpense(i, e);
+        disk.updateExpense(i, e);
+      } else {
+        const size_t i = rng() % memory.size();
+        memory.removeExpense(i);
+        disk.removeExpense(i);
+      }
+      assert(memory.size() == disk.size());
+    }
+    assert(disk.getAllExpenses() == memory.getAllExpenses());
+    assert(disk.getExpense(memory.size() / 2) ==
+           memory.getExpense(memory.size() / 2));
+    assert(disk.getExpensesByCategory("c2") ==
+           memory.getExpensesByCategory("c2"));
+    assert(disk.getExpensesByDateRange("2025-03-01", "2025-03-31") ==
+           memory.getExpensesByDateRange("2025-03-01", "2025-03-31"));
+    size_t visited = 0;
+    disk.forEach([&visited](const models::Expense &) { return ++visited < 100; });
+    assert(visited == 100);
+  }
+  repositories::BPlusTreeExpenseRepository reopened{file.name(), 8, 512};
+  assert(reopened.getAllExpenses() == memory.getAllExpenses());
+}
+
+void testOversizedRecords() {
+  DataStoreFile file{"test_store.bpt"}, sketch{"test_store.bpt.sketch"};
+  DataStoreFile input{"test_store.csv"};
+  const std::string huge(1100, 'x');
+  services::ExpenseService service{
+      std::make_unique<repositories::BPlusTreeExpenseRepository>(file.name())};
+  assert(service.addExpense(huge, 1, "c", "2025-01-01") ==
+         Result::VALIDATION_ERROR);
+  assert(service.getLastError().find("disk store") != std::string::npos);
+  assert(service.addExpense("fits", 1, "c", "2025-01-01") == Result::SUCCESS);
+  assert(service.updateExpense(0, huge, 1, "c", "2025-01-01") ==
+         Result::VALIDATION_ERROR);
+  assert(service.getExpenseCount() == 1 &&
+         service.getAllExpenses()[0].getTitle() == "fits");
+
+  // loads report the row as bad instead of throwing halfway through
+  input.write("\"a\",1,\"c\",\"2025-01-01\"\n\"" + huge +
+              "\",2,\"c\",\"2025-01-02\"\n\"b\",3,\"c\",\"2025-01-03\"\n");
+  repositories::csv::LoadOptions skip;
+  skip.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+  assert(service.loadFromFile(input.name(), skip) == Result::SUCCESS);
+  const auto &result = service.getLastLoadResult();
+  assert(result.rowsLoaded == 2 && result.rowsSkipped == 1);
+  assert(result.diagnostics.size() == 1 &&
+         result.diagnostics[0].lineNumber == 2);
+  assert(service.loadFromFile(input.name()) == Result::FILE_ERROR);
+  assert(service.getExpenseCount() == 1);
+  assert(service.importFile(input.name(), skip) == Result::SUCCESS);
+  assert(service.getExpenseCount() == 2);
+
+  // the in-memory store has no such limit
+  services::ExpenseService memory{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  assert(memory.addExpense(huge, 1, "c", "2025-01-01") == Result::SUCCESS);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"tree matches std::map", testTreeMatchesMap},
+      {"repository matches memory", testRepositoryMatchesMemory},
+      {"oversized records", testOversizedRecords},
+  });
+}
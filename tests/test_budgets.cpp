@@ -0,0 +1,192 @@
+#include "test_support.hpp"
+
+#include <sstream>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+using Result = services::ExpenseService::OperationResult;
+
+namespace {
+const std::string kCoffee = "\"Coffee\",3.5,\"Food\",\"2025-01-01\"\n";
+
+// The in-memory store, then the disk store kept in @p store
+std::unique_ptr<repositories::ExpenseRepository>
+backend(bool disk, const DataStoreFile &store) {
+  if (disk) {
+    return std::make_unique<repositories::BPlusTreeExpenseRepository>(
+        store.name());
+  }
+  return std::make_unique<repositories::InMemoryExpenseRepository>();
+}
+
+bool alerted(const services::ExpenseService &service, bool exceeded) {
+  const auto &alerts = service.getLastAlerts();
+  return alerts.size() == 1 && alerts[0].category == "Food" &&
+         alerts[0].exceeded == exceeded;
+}
+
+void testThresholdCrossings() {
+  DataStoreFile budgets{"budgets.csv"}, store{"test_budgets.bpt"},
+      sketch{"test_budgets.bpt.sketch"};
+  for (bool disk : {false, true}) {
+    budgets.write("");
+    services::ExpenseService service{backend(disk, store)};
+    service.addExpense("x", 70, "Food", "2025-03-01");
+    assert(service.setBudget("Food", 100, 80) == Result::SUCCESS);
+
+    // add: below, then warning, then over
+    service.addExpense("y", 5, "Food", "2025-03-02");
+    assert(service.getLastAlerts().empty());
+    service.addExpense("z", 6, "Food", "2025-03-03");
+    assert(alerted(service, false));
+    assert(service.getLastAlerts()[0].month == "2025-03");
+    service.addExpense("w", 30, "Food", "2025-03-04");
+    assert(alerted(service, true));
+    // already over: no new alert
+    service.updateExpense(3, "w", 31, "Food", "2025-03-04");
+    assert(service.getLastAlerts().empty());
+
+    // delete drops the month back below; update crosses again
+    service.deleteExpense(3);
+    assert(service.getLastAlerts().empty());
+    assert(service.getBudgetSpend("Food", "2025-03-15") == 81);
+    service.updateExpense(2, "z", 30, "Food", "2025-03-03");
+    assert(alerted(service, true));
+
+    // moving a row to another month counts there, not here
+    service.updateExpense(2, "z", 90, "Food", "2025-04-03");
+    assert(alerted(service, false) &&
+           service.getLastAlerts()[0].month == "2025-04");
+    assert(service.getBudgetSpend("Food", "2025-03-01") == 75);
+
+    // categories without a budget never alert
+    service.addExpense("rent", 999, "Rent", "2025-03-01");
+    assert(service.getLastAlerts().empty());
+  }
+}
+
+void testSetBudgetCounts() {
+  DataStoreFile budgets{"budgets.csv"}, store{"test_budgets.bpt"},
+      sketch{"test_budgets.bpt.sketch"};
+  for (bool disk : {false, true}) {
+    budgets.write("");
+    services::ExpenseService service{backend(disk, store)};
+    service.addExpense("a", 10, "Food", "2025-01-05");
+    service.addExpense("b", 20, "Food", "2025-01-20");
+    service.addExpense("c", 40, "Food", "2025-02-01");
+    service.addExpense("d", 80, "Fun", "2025-01-05");
+    service.addExpense("e", 1, "Food", "not a date");
+    assert(service.setBudget("Food", 100) == Result::SUCCESS);
+    assert(service.getBudgetSpend("Food", "2025-01-31") == 30);
+    assert(service.getBudgetSpend("Food", "2025-02-01") == 40);
+    assert(service.getBudgetSpend("Fun", "2025-01-05") == 0);
+
+    // replacing a budget recounts rather than adding up twice
+    assert(service.setBudget("Food", 50, 50) == Result::SUCCESS);
+    assert(service.getBudgetSpend("Food", "2025-01-31") == 30);
+    assert(service.getBudgets().at("Food").warnPercent == 50);
+
+    assert(service.setBudget("", 10) == Result::VALIDATION_ERROR);
+    assert(service.setBudget("Food", 0) == Result::VALIDATION_ERROR);
+    assert(service.setBudget("Food", 10, 101) == Result::VALIDATION_ERROR);
+    assert(service.removeBudget("Fun") == Result::VALIDATION_ERROR);
+    assert(service.removeBudget("Food") == Result::SUCCESS);
+    assert(service.getBudgets().empty());
+  }
+}
+
+void testRestartAndLoads() {
+  DataStoreFile budgets{"budgets.csv"}, store{"test_budgets.bpt"},
+      sketch{"test_budgets.bpt.sketch"}, follow{"test_budgets.bpt.follow"},
+      input{"test_budgets.csv"};
+  {
+    services::ExpenseService service{backend(true, store)};
+    service.addExpense("x", 95, "Food", "2025-03-01");
+    service.setBudget("Food", 100);
+  }
+  {
+    // counters come back from the stored rows, without replaying alerts
+    services::ExpenseService service{backend(true, store)};
+    assert(service.getBudgets().at("Food").limit == 100);
+    assert(service.getBudgetSpend("Food", "2025-03-31") == 95);
+    assert(service.getLastAlerts().empty());
+
+    // appending loads alert row by row
+    input.write("\"y\",10,\"Food\",\"2025-03-02\"\n");
+    repositories::csv::LoadOptions append;
+    append.append = true;
+    assert(service.loadFromFile(input.name(), append) == Result::SUCCESS);
+    assert(alerted(service, true));
+
+    // a load replacing every row recounts
+    input.write("\"z\",85,\"Food\",\"2025-04-02\"\n");
+    assert(service.loadFromFile(input.name()) == Result::SUCCESS);
+    assert(alerted(service, false));
+    assert(service.getBudgetSpend("Food", "2025-03-31") == 0);
+    assert(service.getBudgetSpend("Food", "2025-04-30") == 85);
+  }
+}
+
+// What --disk startup does, as main() calls it
+bool startup(const DataStoreFile &store, const DataStoreFile &input) {
+  auto app = factory::ExpenseTrackerFactory::createDiskBackedApplication(
+      store.name(), 64);
+  std::ostringstream captured;
+  auto *previous = std::cout.rdbuf(captured.rdbuf());
+  const bool loaded = app->loadOnStartup(input.name(), true);
+  std::cout.rdbuf(previous);
+  return loaded;
+}
+
+size_t storedRows(const DataStoreFile &store) {
+  return repositories::BPlusTreeExpenseRepository{store.name()}.size();
+}
+
+void testStartupResumesDiskStore() {
+  DataStoreFile budgets{"budgets.csv"}, store{"test_budgets.bpt"},
+      sketch{"test_budgets.bpt.sketch"}, follow{"test_budgets.bpt.follow"},
+      input{"test_budgets.csv"};
+  budgets.write("");
+  // two real purchases that look alike are both kept
+  input.write(kCoffee + kCoffee + "\"Bus\",2,\"Transport\",\"2025-01-01\"\n");
+  assert(startup(store, input));
+  assert(storedRows(store) == 3);
+
+  // the next start reads nothing twice
+  assert(startup(store, input));
+  assert(storedRows(store) == 3);
+
+  // only what was appended since, repeats included
+  input.append(kCoffee + "\"Tea\",2,\"Food\",\"2025-01-02\"\n");
+  assert(startup(store, input));
+  assert(storedRows(store) == 5);
+
+  // a file rewritten shorter is read from the start
+  input.write(kCoffee);
+  assert(startup(store, input));
+  assert(storedRows(store) == 6);
+
+  DataStoreFile missing{"test_budgets_missing.csv"};
+  assert(!startup(store, missing));
+
+  // budgets see every row appended on the way
+  // 4 coffees and a tea: 16 of 22 spent, short of the 80% warning
+  budgets.write("\"Food\",22,80\n");
+  services::ExpenseService service{backend(true, store)};
+  input.append(kCoffee + kCoffee);
+  assert(service.resumeFile(input.name(), {}) == Result::SUCCESS);
+  assert(service.getLastLoadResult().rowsLoaded == 2);
+  const auto &alerts = service.getLastAlerts();
+  assert(alerts.size() == 2 && !alerts[0].exceeded && alerts[1].exceeded);
+  assert(service.getBudgetSpend("Food", "2025-01-01") == 23);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"threshold crossings", testThresholdCrossings},
+      {"set budget counts", testSetBudgetCounts},
+      {"restart and loads", testRestartAndLoads},
+      {"startup resumes disk store", testStartupResumesDiskStore},
+  });
+}
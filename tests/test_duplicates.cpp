@@ -0,0 +1,153 @@
+#include "test_support.hpp"
+
+using namespace expense_tracker;
+using repositories::csv::DuplicatePolicy;
+using repositories::csv::LoadOptions;
+using testing::DataStoreFile;
+using Result = services::ExpenseService::OperationResult;
+
+namespace {
+const models::Expense kCoffee{"Coffee", 3.5, "Food", "2025-01-01"};
+const models::Expense kRent{"Rent", 900, "Home", "2025-01-02"};
+// same fingerprint as kCoffee: case, padding and date layout differ
+const char *kCoffeeAgain = "\" coffee \",3.50,\"Food\",\"2025-01-01 08:15:00\"";
+const char *kTaxi = "\"Taxi\",12,\"Travel\",\"2025-01-03\"";
+
+struct Store {
+  std::unique_ptr<DataStoreFile> file, sketch, follow;
+  std::unique_ptr<repositories::ExpenseRepository> repository;
+};
+
+Store makeStore(bool disk) {
+  Store store;
+  if (disk) {
+    store.file = std::make_unique<DataStoreFile>("test_duplicates.bpt");
+    store.sketch = std::make_unique<DataStoreFile>("test_duplicates.bpt.sketch");
+    store.follow = std::make_unique<DataStoreFile>("test_duplicates.bpt.follow");
+    store.repository =
+        std::make_unique<repositories::BPlusTreeExpenseRepository>(
+            store.file->name(), 16);
+  } else {
+    store.repository =
+        std::make_unique<repositories::InMemoryExpenseRepository>();
+  }
+  store.repository->addExpense(kCoffee);
+  store.repository->addExpense(kRent);
+  return store;
+}
+
+LoadOptions appending(DuplicatePolicy policy) {
+  LoadOptions options;
+  options.append = true;
+  options.duplicates = policy;
+  return options;
+}
+
+// Coffee again and a new row, through the four policies
+void checkPolicy(DuplicatePolicy policy,
+                 const repositories::ExpenseRepository &repository,
+                 const repositories::csv::LoadResult &result) {
+  assert(result.ok && result.rowsSkipped == 0);
+  const auto incoming = *models::Expense::fromCsv(kCoffeeAgain);
+  const auto taxi = *models::Expense::fromCsv(kTaxi);
+  std::vector<models::Expense> expected;
+  switch (policy) {
+  case DuplicatePolicy::KEEP:
+    assert(result.duplicates == 0 && result.rowsLoaded == 2);
+    expected = {kCoffee, kRent, incoming, taxi};
+    break;
+  case DuplicatePolicy::SKIP:
+    assert(result.duplicates == 1 && result.rowsLoaded == 1);
+    expected = {kCoffee, kRent, taxi};
+    break;
+  case DuplicatePolicy::FLAG:
+    assert(result.duplicates == 1 && result.rowsLoaded == 2);
+    assert(result.diagnostics.size() == 1 &&
+           result.diagnostics[0].lineNumber == 1 &&
+           result.diagnostics[0].reason.find("Duplicate") != std::string::npos);
+    expected = {kCoffee, kRent, incoming, taxi};
+    break;
+  case DuplicatePolicy::MERGE:
+    assert(result.duplicates == 1 && result.rowsLoaded == 1);
+    expected = {incoming, kRent, taxi};
+    break;
+  }
+  assert(repository.getAllExpenses() == expected);
+  // the index follows merged rows: the old text is gone, the new one found
+  assert(repository.containsDuplicate(incoming) &&
+         repository.containsDuplicate(taxi));
+}
+
+constexpr DuplicatePolicy kPolicies[] = {
+    DuplicatePolicy::KEEP, DuplicatePolicy::SKIP, DuplicatePolicy::FLAG,
+    DuplicatePolicy::MERGE};
+
+void testAppendingLoad() {
+  DataStoreFile input{"test_duplicates.csv"};
+  input.write(std::string(kCoffeeAgain) + "\n" + kTaxi + "\n");
+  for (bool disk : {false, true}) {
+    for (auto policy : kPolicies) {
+      auto store = makeStore(disk);
+      auto result =
+          store.repository->loadFromFile(input.name(), appending(policy));
+      checkPolicy(policy, *store.repository, result);
+    }
+  }
+}
+
+void testFollowedLines() {
+  const std::vector<tail::Line> lines{{kCoffeeAgain, 0, 1},
+                                      {kTaxi, 60, 2}};
+  for (bool disk : {false, true}) {
+    for (auto policy : kPolicies) {
+      auto store = makeStore(disk);
+      auto result = store.repository->appendLines(lines, appending(policy));
+      checkPolicy(policy, *store.repository, result);
+      assert(result.bytesRead == 60 + std::string(kTaxi).size() + 1);
+    }
+  }
+}
+
+void testPipelinedImport() {
+  DataStoreFile input{"test_duplicates.csv"};
+  input.write(std::string(kCoffeeAgain) + "\n" + kTaxi + "\n");
+  for (auto policy : kPolicies) {
+    services::ExpenseService service{makeStore(false).repository};
+    importer::Options tuning;
+    tuning.chunkBytes = 16;
+    assert(service.importFile(input.name(), appending(policy), tuning) ==
+           Result::SUCCESS);
+    const auto &result = service.getLastLoadResult();
+    assert(result.duplicates == (policy == DuplicatePolicy::KEEP ? 0 : 1));
+    assert(service.getExpenseCount() ==
+           (policy == DuplicatePolicy::SKIP || policy == DuplicatePolicy::MERGE
+                ? 3
+                : 4));
+  }
+}
+
+void testArchiveImport() {
+  DataStoreFile archiveFile{"test_duplicates.arc"};
+  for (auto policy : kPolicies) {
+    services::ExpenseService service{makeStore(false).repository};
+    assert(service.exportArchive(archiveFile.name()) == Result::SUCCESS);
+    assert(service.importArchive(archiveFile.name(), {}, policy) ==
+           Result::SUCCESS);
+    const size_t duplicates = service.getLastArchiveStats().duplicates;
+    assert(duplicates == (policy == DuplicatePolicy::KEEP ? 0 : 2));
+    assert(service.getExpenseCount() ==
+           (policy == DuplicatePolicy::KEEP || policy == DuplicatePolicy::FLAG
+                ? 4
+                : 2));
+  }
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"appending load", testAppendingLoad},
+      {"followed lines", testFollowedLines},
+      {"pipelined import", testPipelinedImport},
+      {"archive import", testArchiveImport},
+  });
+}
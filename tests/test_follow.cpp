@@ -0,0 +1,195 @@
+#include "test_support.hpp"
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+using Result = services::ExpenseService::OperationResult;
+using repositories::csv::LoadOptions;
+using repositories::csv::LoadResult;
+
+namespace {
+std::string line(const std::string &title, int amount) {
+  return "\"" + title + "\"," + std::to_string(amount) +
+         ",\"c\",\"2025-01-0" + std::to_string(amount % 9 + 1) + "\"\n";
+}
+
+std::vector<std::string> titles(const services::ExpenseService &service) {
+  std::vector<std::string> result;
+  for (const auto &e : service.getAllExpenses()) {
+    result.push_back(e.getTitle());
+  }
+  return result;
+}
+
+// Both backends; the disk store keeps its files in @p store
+std::vector<std::unique_ptr<repositories::ExpenseRepository>>
+backends(const DataStoreFile &store) {
+  std::vector<std::unique_ptr<repositories::ExpenseRepository>> result;
+  result.push_back(std::make_unique<repositories::InMemoryExpenseRepository>());
+  result.push_back(
+      std::make_unique<repositories::BPlusTreeExpenseRepository>(store.name()));
+  return result;
+}
+
+LoadOptions skipBadRows() {
+  LoadOptions options;
+  options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+  return options;
+}
+
+void testPartialLastLine() {
+  DataStoreFile feed{"test_follow.csv"}, store{"test_follow.bpt"},
+      sketch{"test_follow.bpt.sketch"}, follow{"test_follow.bpt.follow"};
+  for (auto &repository : backends(store)) {
+    services::ExpenseService service{std::move(repository)};
+    // B is cut short while being written
+    feed.write(line("A", 1) + "\"B\",2,\"c\",\"2025-01-0");
+    assert(service.loadFromFile(feed.name()) == Result::SUCCESS);
+    const auto &loaded = service.getLastLoadResult();
+    assert(loaded.linesRead == 1 && loaded.rowsSkipped == 0 &&
+           loaded.bytesRead == line("A", 1).size());
+    assert((titles(service) == std::vector<std::string>{"A"}));
+
+    feed.append("3\"\n" + line("C", 3));
+    assert(service.followFile(feed.name(), {},
+                              [](const LoadResult &) { return false; }) ==
+           Result::SUCCESS);
+    assert(service.getLastLoadResult().rowsSkipped == 0);
+    assert((titles(service) == std::vector<std::string>{"A", "B", "C"}));
+  }
+}
+
+void testWholeLastRowWithoutNewline() {
+  DataStoreFile feed{"test_follow.csv"};
+  services::ExpenseService service{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  std::string text = line("A", 1) + line("B", 2);
+  text.pop_back();
+  feed.write(text);
+  assert(service.loadFromFile(feed.name()) == Result::SUCCESS);
+  assert(service.getExpenseCount() == 2 &&
+         service.getLastLoadResult().bytesRead == text.size());
+
+  // its newline arriving later is not a second copy
+  feed.append("\n" + line("C", 3));
+  service.followFile(feed.name(), {}, [](const LoadResult &) { return false; });
+  assert((titles(service) == std::vector<std::string>{"A", "B", "C"}));
+}
+
+void testFollowSession() {
+  DataStoreFile feed{"test_follow.csv"}, rotated{"test_follow.csv.1"},
+      store{"test_follow.bpt"}, sketch{"test_follow.bpt.sketch"},
+      follow{"test_follow.bpt.follow"};
+  for (auto &repository : backends(store)) {
+    services::ExpenseService service{std::move(repository)};
+    feed.write(line("a", 1) + line("b", 2));
+    assert(service.loadFromFile(feed.name()) == Result::SUCCESS);
+    int step = 0;
+    auto result = service.followFile(
+        feed.name(), skipBadRows(),
+        [&](const LoadResult &batch) {
+          const size_t rows = service.getExpenseCount();
+          switch (step++) {
+          case 0:
+            assert(rows == 2);
+            feed.append(line("c", 3) + "\"d\",4,\"c\"");
+            return true;
+          case 1: // d waits for its newline
+            assert(rows == 3);
+            feed.append(",\"2025-01-05\"\nbad\n");
+            return true;
+          case 2:
+            assert(rows == 4 && batch.rowsSkipped == 1 &&
+                   batch.diagnostics.size() == 1 &&
+                   batch.diagnostics[0].lineNumber == 5);
+            feed.write(line("e", 5)); // truncated: read from the start
+            return true;
+          case 3:
+            assert(rows == 5);
+            // rotation: the old file is drained, then the new one read
+            feed.append(line("f", 6));
+            fs::rename(feed.path(), rotated.path());
+            feed.write(line("g", 7));
+            return true;
+          default:
+            if (rows == 6) { // only the old file drained so far
+              return true;
+            }
+            assert(rows == 7);
+            return false;
+          }
+        },
+        10);
+    assert(result == Result::SUCCESS);
+    assert((titles(service) ==
+            std::vector<std::string>{"a", "b", "c", "d", "e", "f", "g"}));
+    assert(service.getLastLoadResult().rowsLoaded == 5);
+
+    // a later session resumes where this one stopped
+    feed.append(line("h", 8));
+    service.followFile(feed.name(), {},
+                       [](const LoadResult &) { return false; });
+    assert(service.getExpenseCount() == 8);
+  }
+}
+
+void testFailedBatchResumesAtBadLine() {
+  DataStoreFile feed{"test_follow.csv"};
+  services::ExpenseService service{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  feed.write(line("a", 1) + "bad\n" + line("b", 2));
+  assert(service.followFile(feed.name(), {}, [](const LoadResult &) {
+    return false;
+  }) == Result::FILE_ERROR);
+  assert(service.getExpenseCount() == 1);
+  // the line is fixed in place: following picks up from it
+  feed.write(line("a", 1) + line("x", 3) + line("b", 2));
+  assert(service.followFile(feed.name(), {}, [](const LoadResult &) {
+    return false;
+  }) == Result::SUCCESS);
+  assert((titles(service) == std::vector<std::string>{"a", "x", "b"}));
+}
+
+void testDiskStoreResumesAfterRestart() {
+  DataStoreFile feed{"test_follow.csv"}, store{"test_follow.bpt"},
+      sketch{"test_follow.bpt.sketch"}, follow{"test_follow.bpt.follow"};
+  feed.write(line("a", 1) + line("b", 2));
+  auto open = [&store] {
+    return services::ExpenseService{
+        std::make_unique<repositories::BPlusTreeExpenseRepository>(
+            store.name())};
+  };
+  {
+    auto service = open();
+    service.followFile(feed.name(), {},
+                       [](const LoadResult &) { return false; });
+    assert(service.getExpenseCount() == 2);
+  }
+  feed.append(line("c", 3));
+  auto service = open();
+  service.followFile(feed.name(), {}, [](const LoadResult &) { return false; });
+  assert((titles(service) == std::vector<std::string>{"a", "b", "c"}));
+
+  // idle polls leave the store and its follow position untouched
+  const auto storeTime = fs::last_write_time(store.path());
+  const auto followTime = fs::last_write_time(follow.path());
+  int polls = 0;
+  service.followFile(
+      feed.name(), {}, [&polls](const LoadResult &) { return ++polls < 3; },
+      10);
+  assert(polls == 3 && service.getExpenseCount() == 3);
+  assert(fs::last_write_time(store.path()) == storeTime &&
+         fs::last_write_time(follow.path()) == followTime);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"partial last line", testPartialLastLine},
+      {"whole last row without newline", testWholeLastRowWithoutNewline},
+      {"follow session", testFollowSession},
+      {"failed batch resumes at bad line",
+       testFailedBatchResumesAtBadLine},
+      {"disk store resumes after restart",
+       testDiskStoreResumesAfterRestart},
+  });
+}
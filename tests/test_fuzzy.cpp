@@ -0,0 +1,199 @@
+#include "test_support.hpp"
+
+#include <random>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+
+namespace {
+size_t referenceDistance(const std::string &a, const std::string &b) {
+  std::vector<std::vector<size_t>> d(a.size() + 1,
+                                     std::vector<size_t>(b.size() + 1));
+  for (size_t i = 0; i <= a.size(); ++i) {
+    d[i][0] = i;
+  }
+  for (size_t j = 0; j <= b.size(); ++j) {
+    d[0][j] = j;
+  }
+  for (size_t i = 1; i <= a.size(); ++i) {
+    for (size_t j = 1; j <= b.size(); ++j) {
+      d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1,
+                          d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+    }
+  }
+  return d[a.size()][b.size()];
+}
+
+std::string randomText(std::mt19937 &rng, size_t maxLength,
+                       const char *alphabet = "abcd") {
+  const size_t letters = std::strlen(alphabet);
+  std::string text(rng() % (maxLength + 1), ' ');
+  for (char &c : text) {
+    c = alphabet[rng() % letters];
+  }
+  return text;
+}
+
+void testEditDistance() {
+  std::mt19937 rng(3);
+  for (int i = 0; i < 20000; ++i) {
+    // patterns over 64 bytes take the dynamic programme
+    const std::string pattern = randomText(rng, i % 10 == 0 ? 90 : 64);
+    const std::string text = randomText(rng, 70);
+    assert(fuzzy::EditDistance{pattern}(text) ==
+           referenceDistance(pattern, text));
+  }
+  assert(fuzzy::EditDistance{std::string(64, 'a')}(std::string(64, 'a')) == 0);
+  assert(fuzzy::EditDistance{"launch"}("lunch") == 1);
+  assert(fuzzy::EditDistance{""}("abc") == 3);
+}
+
+void testBkTreeMatchesBruteForce() {
+  std::mt19937 rng(9);
+  fuzzy::BkTree tree;
+  std::map<std::string, size_t> counts;
+  for (int i = 0; i < 3000; ++i) {
+    std::string term = randomText(rng, 8);
+    if (rng() % 3 == 0 && counts.count(term)) {
+      tree.remove(term);
+      if (--counts[term] == 0) {
+        counts.erase(term);
+      }
+    } else {
+      tree.add(term);
+      ++counts[term];
+    }
+  }
+  assert(tree.size() == counts.size());
+  for (int i = 0; i < 200; ++i) {
+    const std::string query = randomText(rng, 8);
+    const size_t maxDistance = rng() % 3;
+    std::vector<std::string> expected;
+    for (const auto &[term, count] : counts) {
+      if (referenceDistance(query, term) <= maxDistance) {
+        expected.push_back(term);
+      }
+    }
+    std::vector<std::string> found;
+    for (const auto &m : tree.search(query, maxDistance)) {
+      assert(m.distance == referenceDistance(query, m.term));
+      found.push_back(m.term);
+    }
+    std::sort(found.begin(), found.end());
+    assert(found == expected);
+  }
+}
+
+// What fuzzySearchExpenses() should return, checked row by row
+repositories::ExpenseRepository::ExpenseList
+bruteForce(const repositories::ExpenseRepository &repository,
+           const std::string &query, size_t maxDistance) {
+  repositories::ExpenseRepository::ExpenseList rows;
+  const auto normalized = fuzzy::normalize(query);
+  repository.forEach([&](const models::Expense &e) {
+    if (referenceDistance(normalized, fuzzy::normalize(e.getTitle())) <=
+            maxDistance ||
+        referenceDistance(normalized, fuzzy::normalize(e.getCategory())) <=
+            maxDistance) {
+      rows.push_back(e);
+    }
+    return true;
+  });
+  return rows;
+}
+
+models::Expense randomExpense(std::mt19937 &rng) {
+  static const char *const kTitles[] = {"Coffee", "coffee ", "Cofee",
+                                        "Lunch",  "Launch", "Taxi",
+                                        "Rent",   "food",   "Groceries"};
+  static const char *const kCategories[] = {"Food", "Transport", "Housing",
+                                            "Taxi", "Fun"};
+  return models::Expense(kTitles[rng() % 9] + randomText(rng, 2, "xy"),
+                         rng() % 100 + 1, kCategories[rng() % 5],
+                         "2025-01-01");
+}
+
+void checkSearches(const repositories::ExpenseRepository &repository,
+                   std::mt19937 &rng) {
+  for (const char *query :
+       {"coffee", "COFEE", "lunch", "taxi", "food", "housing", "zzz", ""}) {
+    for (size_t maxDistance : {0, 1, 2}) {
+      assert(repository.fuzzySearchExpenses(query, maxDistance) ==
+             bruteForce(repository, query, maxDistance));
+    }
+  }
+  const std::string query = randomText(rng, 6, "acefot");
+  assert(repository.fuzzySearchExpenses(query, 2) ==
+         bruteForce(repository, query, 2));
+}
+
+void testRepositoriesMatchBruteForce() {
+  DataStoreFile file{"test_fuzzy.bpt"}, sketch{"test_fuzzy.bpt.sketch"};
+  std::mt19937 rng(21);
+  {
+    repositories::InMemoryExpenseRepository memory;
+    repositories::BPlusTreeExpenseRepository disk{file.name(), 8, 512};
+    for (int step = 0; step < 2000; ++step) {
+      const auto e = randomExpense(rng);
+      const unsigned op = rng() % 10;
+      if (op < 6 || memory.size() == 0) {
+        memory.addExpense(e);
+        disk.addExpense(e);
+      } else if (op < 8) {
+        const size_t i = rng() % memory.size();
+        memory.updateExpense(i, e);
+        disk.updateExpense(i, e);
+      } else {
+        const size_t i = rng() % memory.size();
+        memory.removeExpense(i);
+        disk.removeExpense(i);
+      }
+      if (step % 400 == 0) { // searches between edits keep the terms live
+        checkSearches(memory, rng);
+        checkSearches(disk, rng);
+      }
+    }
+    checkSearches(memory, rng);
+    checkSearches(disk, rng);
+  }
+  // reopened: the term index comes back from the file
+  repositories::BPlusTreeExpenseRepository reopened{file.name(), 8, 512};
+  checkSearches(reopened, rng);
+  reopened.addExpense(models::Expense("Cofeee", 1, "Fun", "2025-01-02"));
+  reopened.removeExpense(0);
+  checkSearches(reopened, rng);
+
+  reopened.clear();
+  assert(reopened.fuzzySearchExpenses("coffee", 2).empty());
+}
+
+void testStoreWithoutTermIndex() {
+  DataStoreFile file{"test_fuzzy.bpt"}, sketch{"test_fuzzy.bpt.sketch"};
+  std::mt19937 rng(4);
+  {
+    repositories::BPlusTreeExpenseRepository disk{file.name(), 8, 512};
+    for (int i = 0; i < 300; ++i) {
+      disk.addExpense(randomExpense(rng));
+    }
+  }
+  {
+    // as written before the term index existed: its metadata slots unset
+    storage::Pager pager{file.path(), 512, 8};
+    pager.setMeta(7, storage::Pager::kNullPage);
+    pager.setMeta(8, 0);
+    pager.flush();
+  }
+  repositories::BPlusTreeExpenseRepository disk{file.name(), 8, 512};
+  assert(!disk.fuzzySearchExpenses("coffee", 1).empty());
+  checkSearches(disk, rng);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"edit distance", testEditDistance},
+      {"bk-tree matches brute force", testBkTreeMatchesBruteForce},
+      {"repositories match brute force", testRepositoriesMatchBruteForce},
+      {"store without term index", testStoreWithoutTermIndex},
+  });
+}
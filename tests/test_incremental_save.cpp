@@ -0,0 +1,148 @@
+#include "test_support.hpp"
+
+#include <sstream>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+
+namespace {
+models::Expense row(int i) {
+  return models::Expense("row " + std::to_string(i), i + 0.5, "c",
+                         "2025-01-" + std::string(i % 28 < 9 ? "0" : "") +
+                             std::to_string(i % 28 + 1));
+}
+
+/// What saveToFile() printed, which says whether it rewrote only some rows.
+std::string save(const repositories::InMemoryExpenseRepository &repository,
+                 const std::string &filename) {
+  std::ostringstream captured;
+  auto *previous = std::cout.rdbuf(captured.rdbuf());
+  const bool saved = repository.saveToFile(filename);
+  std::cout.rdbuf(previous);
+  assert(saved);
+  return captured.str();
+}
+
+bool rewrote(const std::string &log, size_t rows, size_t of) {
+  return log.find("(" + std::to_string(rows) + " of " + std::to_string(of) +
+                  " rows rewritten)") != std::string::npos;
+}
+
+std::string contents(const fs::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), {}};
+}
+
+// Reloading through a fresh repository checks what actually hit the disk
+void checkReloads(const repositories::InMemoryExpenseRepository &repository,
+                  const std::string &filename) {
+  repositories::InMemoryExpenseRepository reloaded;
+  assert(reloaded.loadFromFile(filename));
+  assert(reloaded.getAllExpenses() == repository.getAllExpenses());
+}
+
+void testRewritesOnlyChangedSlots() {
+  DataStoreFile file{"test_save.csv"}, sketch{"test_save.csv.sketch"};
+  repositories::InMemoryExpenseRepository repository;
+  for (int i = 0; i < 50; ++i) {
+    repository.addExpense(row(i));
+  }
+  assert(!rewrote(save(repository, file.name()), 50, 50));
+  const auto size = fs::file_size(file.path());
+  const size_t slot = size / 50;
+  assert(size == slot * 50);
+
+  // a tab in row 30's padding survives only if that slot is left alone
+  std::string bytes = contents(file.path());
+  bytes[30 * slot + slot - 2] = '\t';
+  const auto writeTime = fs::last_write_time(file.path());
+  file.write(bytes);
+  fs::last_write_time(file.path(), writeTime);
+
+  repository.updateExpense(3, row(103));
+  repository.addExpense(row(50));
+  assert(rewrote(save(repository, file.name()), 2, 51));
+  bytes = contents(file.path());
+  assert(bytes.size() == slot * 51 && bytes[30 * slot + slot - 2] == '\t');
+  checkReloads(repository, file.name());
+
+  // nothing changed: nothing rewritten
+  assert(rewrote(save(repository, file.name()), 0, 51));
+}
+
+void testRemovalTruncates() {
+  DataStoreFile file{"test_save.csv"}, sketch{"test_save.csv.sketch"};
+  repositories::InMemoryExpenseRepository repository;
+  for (int i = 0; i < 20; ++i) {
+    repository.addExpense(row(i));
+  }
+  save(repository, file.name());
+  const size_t slot = fs::file_size(file.path()) / 20;
+
+  repository.removeExpense(19);
+  assert(rewrote(save(repository, file.name()), 0, 19));
+  assert(fs::file_size(file.path()) == slot * 19);
+
+  // removing from the middle shifts the tail up
+  repository.removeExpense(5);
+  assert(rewrote(save(repository, file.name()), 13, 18));
+  assert(fs::file_size(file.path()) == slot * 18);
+  checkReloads(repository, file.name());
+}
+
+void testFallsBackToFullRewrite() {
+  DataStoreFile file{"test_save.csv"}, sketch{"test_save.csv.sketch"};
+  DataStoreFile other{"test_save_other.csv"},
+      otherSketch{"test_save_other.csv.sketch"};
+  repositories::InMemoryExpenseRepository repository;
+  for (int i = 0; i < 10; ++i) {
+    repository.addExpense(row(i));
+  }
+  save(repository, file.name());
+
+  // an edit longer than its slot
+  repository.updateExpense(2, models::Expense(std::string(200, 'x'), 1, "c",
+                                              "2025-01-01"));
+  assert(save(repository, file.name()).find("rows rewritten") ==
+         std::string::npos);
+  checkReloads(repository, file.name());
+
+  // the file changed behind our back
+  file.append("\"intruder\",1,\"c\",\"2025-01-01\"\n");
+  repository.updateExpense(0, row(100));
+  assert(save(repository, file.name()).find("rows rewritten") ==
+         std::string::npos);
+  checkReloads(repository, file.name());
+
+  // another target file
+  repository.updateExpense(1, row(101));
+  assert(save(repository, other.name()).find("rows rewritten") ==
+         std::string::npos);
+  checkReloads(repository, other.name());
+}
+
+void testLoadedFileSavesIncrementally() {
+  DataStoreFile file{"test_save.csv"}, sketch{"test_save.csv.sketch"};
+  {
+    repositories::InMemoryExpenseRepository writer;
+    for (int i = 0; i < 10; ++i) {
+      writer.addExpense(row(i));
+    }
+    save(writer, file.name());
+  }
+  repositories::InMemoryExpenseRepository repository;
+  assert(repository.loadFromFile(file.name()));
+  repository.updateExpense(4, row(44));
+  assert(rewrote(save(repository, file.name()), 1, 10));
+  checkReloads(repository, file.name());
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"rewrites only changed slots", testRewritesOnlyChangedSlots},
+      {"removal truncates", testRemovalTruncates},
+      {"falls back to full rewrite", testFallsBackToFullRewrite},
+      {"loaded file saves incrementally", testLoadedFileSavesIncrementally},
+  });
+}
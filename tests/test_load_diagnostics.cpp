@@ -0,0 +1,123 @@
+#include "test_support.hpp"
+
+#include <sstream>
+
+using namespace expense_tracker;
+using repositories::csv::ErrorPolicy;
+using repositories::csv::LoadOptions;
+using repositories::csv::LoadResult;
+using testing::DataStoreFile;
+
+namespace {
+const std::string kGood = "\"ok\",1,\"c\",\"2025-01-01\"\n";
+const std::string kBad = "not a row\n";
+
+// 10 good rows with bad ones on lines 4 and 8 and a blank line 6
+std::string sampleFile() {
+  std::string text;
+  for (int line = 1; line <= 13; ++line) {
+    text += line == 4 || line == 8 ? kBad : line == 6 ? "\n" : kGood;
+  }
+  return text;
+}
+
+LoadResult load(const std::string &filename, const LoadOptions &options,
+                std::string *printed = nullptr) {
+  repositories::InMemoryExpenseRepository repository;
+  std::ostringstream out, err;
+  auto *previousOut = std::cout.rdbuf(out.rdbuf());
+  auto *previousErr = std::cerr.rdbuf(err.rdbuf());
+  auto result = repository.loadFromFile(filename, options);
+  std::cout.rdbuf(previousOut);
+  std::cerr.rdbuf(previousErr);
+  assert(repository.size() == result.rowsLoaded);
+  if (printed) {
+    *printed = out.str() + err.str();
+  }
+  return result;
+}
+
+void testSkipBadRows() {
+  DataStoreFile file{"test_diagnostics.csv"};
+  file.write(sampleFile());
+  LoadOptions options;
+  options.policy = ErrorPolicy::SKIP_BAD_ROWS;
+  std::string printed;
+  auto result = load(file.name(), options, &printed);
+  assert(result.ok && printed.empty()); // quiet by default
+  assert(result.linesRead == 13 && result.rowsLoaded == 10 &&
+         result.rowsSkipped == 2);
+  assert(result.diagnostics.size() == 2);
+  // byte offsets point at the start of the offending line
+  assert(result.diagnostics[0].lineNumber == 4 &&
+         result.diagnostics[0].byteOffset == 3 * kGood.size());
+  assert(result.diagnostics[1].lineNumber == 8 &&
+         result.diagnostics[1].byteOffset ==
+             5 * kGood.size() + kBad.size() + 1);
+  assert(result.diagnostics[0].reason.find("not a row") != std::string::npos);
+}
+
+void testFailFast() {
+  DataStoreFile file{"test_diagnostics.csv"};
+  file.write(sampleFile());
+  auto result = load(file.name(), {});
+  assert(!result.ok);
+  assert(result.linesRead == 4 && result.rowsLoaded == 3 &&
+         result.rowsSkipped == 1);
+  assert(result.diagnostics.size() == 1 &&
+         result.diagnostics[0].lineNumber == 4);
+}
+
+void testDiagnosticsAreCapped() {
+  DataStoreFile file{"test_diagnostics.csv"};
+  std::string text;
+  for (int i = 0; i < 50; ++i) {
+    text += kBad;
+  }
+  file.write(text);
+  LoadOptions options;
+  options.policy = ErrorPolicy::SKIP_BAD_ROWS;
+  options.maxDiagnostics = 5;
+  auto result = load(file.name(), options);
+  assert(result.ok && result.rowsSkipped == 50 &&
+         result.diagnostics.size() == 5);
+}
+
+void testProgressInterval() {
+  DataStoreFile file{"test_diagnostics.csv"};
+  file.write(sampleFile());
+  LoadOptions options;
+  options.policy = ErrorPolicy::SKIP_BAD_ROWS;
+  options.progressInterval = 3;
+  std::vector<size_t> calls;
+  options.onProgress = [&calls](size_t rows) { calls.push_back(rows); };
+  load(file.name(), options);
+  assert((calls == std::vector<size_t>{3, 6, 9}));
+}
+
+void testVerboseAndMissingFile() {
+  DataStoreFile file{"test_diagnostics.csv"};
+  file.write(sampleFile());
+  LoadOptions options;
+  options.policy = ErrorPolicy::SKIP_BAD_ROWS;
+  options.verbose = true;
+  std::string printed;
+  load(file.name(), options, &printed);
+  assert(printed.find("Successfully parsed") != std::string::npos &&
+         printed.find("Line 4") != std::string::npos);
+
+  auto missing = load("test_no_such_file.csv", {});
+  assert(!missing.ok && missing.diagnostics.size() == 1 &&
+         missing.diagnostics[0].lineNumber == 0);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"skip bad rows", testSkipBadRows},
+      {"fail fast", testFailFast},
+      {"diagnostics are capped", testDiagnosticsAreCapped},
+      {"progress interval", testProgressInterval},
+      {"verbose and missing file", testVerboseAndMissingFile},
+  });
+}
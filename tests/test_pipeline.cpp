@@ -0,0 +1,173 @@
+#include "test_support.hpp"
+
+#include <random>
+#include <thread>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+using Result = services::ExpenseService::OperationResult;
+
+namespace {
+void testSpscQueue() {
+  constexpr size_t kItems = 200000;
+  pipeline::SpscQueue<size_t> queue{16};
+  std::thread producer([&queue] {
+    for (size_t i = 0; i < kItems; ++i) {
+      size_t item = i;
+      unsigned spins = 0;
+      while (!queue.tryPush(item)) {
+        pipeline::detail::backoff(spins);
+      }
+    }
+  });
+  for (size_t expected = 0; expected < kItems; ++expected) {
+    size_t item;
+    unsigned spins = 0;
+    while (!queue.tryPop(item)) {
+      pipeline::detail::backoff(spins);
+    }
+    assert(item == expected);
+  }
+  producer.join();
+  size_t item;
+  assert(!queue.tryPop(item));
+}
+
+void testMpmcQueue() {
+  constexpr size_t kProducers = 4, kConsumers = 4, kItems = 50000;
+  std::atomic<bool> cancelled{false};
+  pipeline::Link<size_t, pipeline::MpmcQueue> link{8, kProducers, cancelled};
+  std::vector<std::vector<size_t>> received(kConsumers);
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&link, p] {
+      for (size_t i = 0; i < kItems; ++i) {
+        assert(link.push(p * kItems + i));
+      }
+      link.producerDone();
+    });
+  }
+  for (size_t c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&link, &received, c] {
+      size_t item;
+      while (link.pop(item)) {
+        received[c].push_back(item);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<size_t> all;
+  for (const auto &items : received) {
+    // each producer's items reach a given consumer in push order
+    std::vector<size_t> last(kProducers, SIZE_MAX);
+    for (size_t item : items) {
+      size_t &previous = last[item / kItems];
+      assert(previous == SIZE_MAX || previous < item);
+      previous = item;
+    }
+    all.insert(all.end(), items.begin(), items.end());
+  }
+  std::sort(all.begin(), all.end());
+  assert(all.size() == kProducers * kItems);
+  for (size_t i = 0; i < all.size(); ++i) {
+    assert(all[i] == i);
+  }
+}
+
+void testImportMatchesLoad() {
+  DataStoreFile input{"test_import.csv"};
+  {
+    std::ofstream file(input.path());
+    std::mt19937 rng(13);
+    for (int i = 0; i < 3000; ++i) {
+      if (i % 97 == 5) {
+        file << "not a row\n";
+      } else if (i % 101 == 7) {
+        file << "\n";
+      } else if (i % 103 == 9) {
+        file << "\"zero\",0,\"x\",\"2025-01-01\"\n"; // fails validation
+      } else {
+        file << "\"t" << rng() % 500 << "\"," << (rng() % 10000) / 100.0 + 0.01
+             << ",\"c" << rng() % 7 << "\",\"2025-0" << 1 + rng() % 9 << "-1"
+             << rng() % 9 << "\"\n";
+      }
+    }
+  }
+  repositories::csv::LoadOptions options;
+  options.policy = repositories::csv::ErrorPolicy::SKIP_BAD_ROWS;
+  services::ExpenseService serial{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  assert(serial.loadFromFile(input.name(), options) == Result::SUCCESS);
+  std::vector<models::Expense> expected;
+  serial.forEachExpense([&expected](const models::Expense &expense) {
+    if (expense.getAmount() > 0) {
+      expected.push_back(expense);
+    }
+    return true;
+  });
+  for (size_t chunkBytes : {size_t{1}, size_t{64}, size_t{4096}, size_t{1} << 20}) {
+    for (size_t threads : {1, 3, 0}) {
+      services::ExpenseService service{
+          std::make_unique<repositories::InMemoryExpenseRepository>()};
+      importer::Options tuning;
+      tuning.chunkBytes = chunkBytes;
+      tuning.parserThreads = threads;
+      tuning.queueDepth = 2;
+      assert(service.importFile(input.name(), options, tuning) ==
+             Result::SUCCESS);
+      assert(service.getAllExpenses() == expected);
+      const auto &result = service.getLastLoadResult();
+      assert(result.linesRead == serial.getLastLoadResult().linesRead);
+      assert(result.rowsSkipped == serial.getLastLoadResult().rowsSkipped +
+                                       serial.getExpenseCount() -
+                                       expected.size());
+    }
+  }
+
+  // fail fast stops at the first bad row, with the rows before it stored
+  services::ExpenseService failFast{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  importer::Options small;
+  small.chunkBytes = 128;
+  assert(failFast.importFile(input.name(), {}, small) == Result::FILE_ERROR);
+  assert(failFast.getExpenseCount() == 5);
+}
+
+void testImportTuning() {
+  DataStoreFile input{"test_import.csv"};
+  std::string rows;
+  for (int i = 0; i < 500; ++i) {
+    rows += "\"t" + std::to_string(i) + "\",1,\"c\",\"2025-01-01\"\n";
+  }
+  input.write(rows);
+  services::ExpenseService service{
+      std::make_unique<repositories::InMemoryExpenseRepository>()};
+  assert(service.importFile(input.name()) == Result::SUCCESS);
+  importer::Options tuning;
+  tuning.chunkBytes = 0;
+  assert(service.importFile(input.name(), {}, tuning) == Result::FILE_ERROR);
+  assert(service.getExpenseCount() == 500); // rejected before clearing
+  tuning.chunkBytes = 64;
+  tuning.queueDepth = 0;
+  assert(service.importFile(input.name(), {}, tuning) == Result::FILE_ERROR);
+
+  // a tiny reorder window with more parsers than it lets run
+  tuning.queueDepth = 1;
+  tuning.parserThreads = 1000;
+  assert(service.importFile(input.name(), {}, tuning) == Result::SUCCESS);
+  assert(service.getExpenseCount() == 500);
+  const auto &stages = service.getLastImportStats().stages;
+  assert(stages.size() == 4 && stages[1].threads == importer::kMaxParserThreads);
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"spsc queue", testSpscQueue},
+      {"mpmc queue", testMpmcQueue},
+      {"import matches load", testImportMatchesLoad},
+      {"import tuning", testImportTuning},
+  });
+}
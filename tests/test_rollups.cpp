@@ -0,0 +1,126 @@
+#include "test_support.hpp"
+
+#include <random>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+
+namespace {
+std::string isoDate(std::int64_t day) {
+  dates::CivilTime t;
+  dates::civilFromDays(day, t.year, t.month, t.day);
+  return dates::formatIsoDate(t);
+}
+
+models::Expense onDay(std::int64_t day, double amount,
+                      const std::string &category = "c") {
+  return models::Expense("row", amount, category, isoDate(day));
+}
+
+// What rangeTotal() should say, summed row by row
+double expected(const std::vector<models::Expense> &rows, std::int64_t from,
+                std::int64_t to, const std::string &category = "") {
+  std::int64_t cents = 0;
+  for (const auto &e : rows) {
+    auto day = dates::dayNumber(e.getDate());
+    if (day && *day >= from && *day <= to &&
+        (category.empty() || e.getCategory() == category)) {
+      cents += std::llround(e.getAmount() * 100);
+    }
+  }
+  return static_cast<double>(cents) / 100;
+}
+
+void testBlockEdges() {
+  rollups::DailyTotals totals;
+  std::vector<models::Expense> rows;
+  // both sides of every block and block-group boundary near the epoch
+  for (std::int64_t edge : {-262144, -512, 0, 512, 1024, 262144}) {
+    for (std::int64_t day : {edge - 1, edge, edge + 1}) {
+      rows.push_back(onDay(day, 1.25));
+      totals.add(rows.back());
+    }
+  }
+  for (std::int64_t from : {-262145, -513, -512, -1, 0, 511, 512, 1023}) {
+    for (std::int64_t to : {-512, -1, 0, 1, 511, 512, 1024, 262145}) {
+      assert(totals.rangeTotal(from, to) == expected(rows, from, to));
+    }
+  }
+  assert(totals.rangeTotal(10, 5) == 0.0);
+  assert(totals.rangeTotal(-1, -1) == 1.25);
+  assert(totals.rangeTotal(-262145, 262145) == 18 * 1.25);
+}
+
+void testMatchesBruteForce() {
+  rollups::DailyTotals totals;
+  std::vector<models::Expense> rows;
+  std::mt19937 rng(5);
+  // years 1900..2100, negative days included, plus an unparsable date
+  for (int i = 0; i < 3000; ++i) {
+    const std::int64_t day = static_cast<std::int64_t>(rng() % 73000) - 25567;
+    rows.push_back(onDay(day, (rng() % 100000) / 100.0,
+                         "c" + std::to_string(rng() % 4)));
+    totals.add(rows.back());
+  }
+  rows.push_back(models::Expense("row", 50, "c0", "someday"));
+  totals.add(rows.back());
+  // removals and updates cancel exactly
+  for (int i = 0; i < 1000; ++i) {
+    const size_t victim = rng() % rows.size();
+    totals.remove(rows[victim]);
+    if (i % 2) {
+      rows[victim] = onDay(static_cast<std::int64_t>(rng() % 2000) - 1000,
+                           (rng() % 1000) / 100.0, "c1");
+      totals.add(rows[victim]);
+    } else {
+      rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(victim));
+    }
+  }
+  for (int i = 0; i < 500; ++i) {
+    std::int64_t from = static_cast<std::int64_t>(rng() % 80000) - 30000;
+    std::int64_t to = from + static_cast<std::int64_t>(rng() % 40000);
+    assert(std::llround(totals.rangeTotal(from, to) * 100) ==
+           std::llround(expected(rows, from, to) * 100));
+    const std::string category = "c" + std::to_string(rng() % 4);
+    assert(std::llround(totals.rangeTotal(from, to, category) * 100) ==
+           std::llround(expected(rows, from, to, category) * 100));
+  }
+  assert(totals.rangeTotal(-100000, 100000, "missing") == 0.0);
+
+  for (const auto &e : rows) {
+    totals.remove(e);
+  }
+  assert(totals.rangeTotal(-100000, 100000) == 0.0);
+}
+
+void testServiceRangeTotal() {
+  DataStoreFile file{"test_rollups.bpt"}, sketch{"test_rollups.bpt.sketch"};
+  std::vector<std::unique_ptr<repositories::ExpenseRepository>> stores;
+  stores.push_back(std::make_unique<repositories::InMemoryExpenseRepository>());
+  stores.push_back(
+      std::make_unique<repositories::BPlusTreeExpenseRepository>(file.name()));
+  for (auto &store : stores) {
+    services::ExpenseService service{std::move(store)};
+    service.addExpense("a", 10, "food", "1969-12-31");
+    service.addExpense("b", 20, "rent", "1970-01-01");
+    service.addExpense("c", 30, "food", "2025-06-15 12:00:00");
+    service.addExpense("d", 40, "food", "2025-06-16");
+    service.deleteExpense(3);
+    service.updateExpense(1, "b", 25, "rent", "1970-01-01");
+    assert(service.calculateRangeTotal("1969-01-01", "2025-12-31") == 65.0);
+    assert(service.calculateRangeTotal("1969-12-31", "1969-12-31") == 10.0);
+    assert(service.calculateRangeTotal("1960-01-01", "2030-01-01", "food") ==
+           40.0);
+    assert(service.calculateRangeTotal("2025-06-15", "2025-06-16") == 30.0);
+    assert(!service.calculateRangeTotal("yesterday", "2025-01-01"));
+  }
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"block edges", testBlockEdges},
+      {"matches brute force", testMatchesBruteForce},
+      {"service range total", testServiceRangeTotal},
+  });
+}
@@ -0,0 +1,126 @@
+#include "test_support.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace expense_tracker;
+using testing::DataStoreFile;
+
+namespace {
+models::Expense row(int i, double amount) {
+  return models::Expense("shop " + std::to_string(i % 200), amount,
+                         i % 2 ? "odd" : "even", "2025-01-01");
+}
+
+double median(const stats::ExpenseSketches &sketches) {
+  return sketches.amounts().quantile(0.5);
+}
+
+// Same row count, every amount @p amount: a sidecar lying about the data
+void writeDecoy(const fs::path &sidecar, const fs::path &source, size_t rows,
+                double amount) {
+  stats::ExpenseSketches decoy;
+  for (size_t i = 0; i < rows; ++i) {
+    decoy.add(row(static_cast<int>(i), amount));
+  }
+  assert(decoy.saveToFile(sidecar, source));
+}
+
+void touch(const fs::path &path) {
+  fs::last_write_time(path,
+                      fs::last_write_time(path) + std::chrono::seconds(5));
+}
+
+void testEstimates() {
+  stats::ExpenseSketches sketches;
+  std::mt19937 rng(3);
+  for (int i = 0; i < 20000; ++i) {
+    sketches.add(row(i, 1 + rng() % 1000));
+  }
+  assert(sketches.rows() == 20000);
+  assert(std::abs(median(sketches) - 500) < 30);
+  assert(std::abs(sketches.amounts().quantile(0.95) - 950) < 30);
+  assert(std::abs(sketches.distinctTitles() - 200) < 20);
+  assert(sketches.titleFrequency("shop 7") >= 100);
+  assert(sketches.topTitles(3).size() == 3);
+  assert(sketches.byCategory().size() == 2);
+}
+
+void testInMemorySidecar() {
+  DataStoreFile file{"test_sketches.csv"}, sidecar{"test_sketches.csv.sketch"};
+  {
+    repositories::InMemoryExpenseRepository repository;
+    for (int i = 0; i < 500; ++i) {
+      repository.addExpense(row(i, 10));
+    }
+    assert(repository.saveToFile(file.name()));
+    assert(fs::exists(sidecar.path()));
+  }
+  // an unchanged file: the sidecar is trusted as is
+  writeDecoy(sidecar.path(), file.path(), 500, 99);
+  {
+    repositories::InMemoryExpenseRepository repository;
+    assert(repository.loadFromFile(file.name()));
+    assert(median(repository.getSketches()) == 99);
+  }
+  // same rows, different file: rebuilt from the rows
+  touch(file.path());
+  {
+    repositories::InMemoryExpenseRepository repository;
+    assert(repository.loadFromFile(file.name()));
+    assert(median(repository.getSketches()) == 10);
+  }
+  // edited outside the app, keeping the row count
+  {
+    std::string rows;
+    for (int i = 0; i < 500; ++i) {
+      rows += row(i, 20).toCsv() + "\n";
+    }
+    file.write(rows);
+    repositories::InMemoryExpenseRepository repository;
+    assert(repository.loadFromFile(file.name()));
+    assert(median(repository.getSketches()) == 20);
+  }
+}
+
+void testDiskSidecar() {
+  DataStoreFile file{"test_sketches.bpt"}, sidecar{"test_sketches.bpt.sketch"};
+  {
+    repositories::BPlusTreeExpenseRepository repository{file.name()};
+    for (int i = 0; i < 500; ++i) {
+      repository.addExpense(row(i, 10));
+    }
+  }
+  assert(fs::exists(sidecar.path()));
+  {
+    repositories::BPlusTreeExpenseRepository repository{file.name()};
+    assert(median(repository.getSketches()) == 10);
+  }
+  writeDecoy(sidecar.path(), file.path(), 500, 99);
+  {
+    repositories::BPlusTreeExpenseRepository repository{file.name()};
+    assert(median(repository.getSketches()) == 99);
+  }
+  writeDecoy(sidecar.path(), file.path(), 500, 99);
+  touch(file.path());
+  {
+    repositories::BPlusTreeExpenseRepository repository{file.name()};
+    assert(median(repository.getSketches()) == 10);
+  }
+  // a removal makes the sidecar stale at once
+  {
+    repositories::BPlusTreeExpenseRepository repository{file.name()};
+    repository.removeExpense(0);
+    assert(!fs::exists(sidecar.path()));
+    assert(repository.getSketches().rows() == 499);
+  }
+}
+} // namespace
+
+int main() {
+  return testing::run({
+      {"estimates", testEstimates},
+      {"in-memory sidecar", testInMemorySidecar},
+      {"disk sidecar", testDiskSidecar},
+  });
+}
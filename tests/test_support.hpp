@@ -0,0 +1,72 @@
+#pragma once
+
+// The checks call the code under test inside assert()
+#undef NDEBUG
+
+#include "app_per_traker_command.hpp"
+
+#include <cassert>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace expense_tracker {
+namespace testing {
+inline const fs::path kDataStore = "./data_store";
+
+/**
+ * @brief File under data_store/ owned by one test
+ *
+ * Whatever the file held before the test is put back afterwards, so tests
+ * can use the repositories' fixed data_store/ directory without disturbing
+ * a real history or budget file.
+ */
+class DataStoreFile {
+public:
+  explicit DataStoreFile(std::string name) : name_{std::move(name)} {
+    fs::create_directories(kDataStore);
+    std::ifstream existing(path(), std::ios::binary);
+    if (existing.is_open()) {
+      saved_ = std::string{std::istreambuf_iterator<char>(existing), {}};
+    }
+    fs::remove(path());
+  }
+  ~DataStoreFile() {
+    std::error_code ec;
+    fs::remove(path(), ec);
+    if (saved_) {
+      std::ofstream(path(), std::ios::binary) << *saved_;
+    }
+  }
+  DataStoreFile(const DataStoreFile &) = delete;
+  DataStoreFile &operator=(const DataStoreFile &) = delete;
+
+  const std::string &name() const noexcept { return name_; }
+  fs::path path() const { return kDataStore / name_; }
+
+  void write(const std::string &content) const {
+    std::ofstream(path(), std::ios::binary | std::ios::trunc) << content;
+  }
+  void append(const std::string &content) const {
+    std::ofstream(path(), std::ios::binary | std::ios::app) << content;
+  }
+
+private:
+  std::string name_;
+  std::optional<std::string> saved_;
+};
+
+using Test = std::pair<const char *, void (*)()>;
+
+/// Runs @p tests in order; a failing check aborts through assert().
+inline int run(std::initializer_list<Test> tests) {
+  for (const auto &[name, test] : tests) {
+    test();
+    std::cout << "ok   " << name << std::endl;
+  }
+  return 0;
+}
+} // namespace testing
+} // namespace expense_tracker